@@ -0,0 +1,377 @@
+//
+// bench.cc
+//
+// Benchmarks of every stage from reading a polygon to writing its
+// triangulation, over the sizes of the polygons, with the fitted complexity
+//
+// In addition to the flags of Google Benchmark, e.g., --benchmark_filter,
+//   --max_random_size=N  largest random polygon to benchmark (default 20480)
+//
+// The random polygons are generated once for each size, before the first
+// benchmark using them.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/cache.h"
+#include "core/fileio.h"
+#include "core/geometry.h"
+#include "core/incremental.h"
+#include "core/metrics.h"
+#include "core/polygon.h"
+#include "core/random_polygon.h"
+
+namespace {
+
+//// Shapes
+
+// .regular: the same points as polygons/regular_polygon_<n>.csv
+// .random: random simple polygon by random_polygon()
+// .star: every other vertex is the tip of a narrow spike, so half of the
+//   vertices are reflex
+// .comb: long narrow teeth along a base, so most ears are blocked by the
+//   reflex vertices between the teeth
+enum class Shape { regular, random, star, comb };
+
+std::string
+shape_name (const Shape shape) {
+    switch (shape) {
+    case Shape::regular: return "regular";
+    case Shape::random: return "random";
+    case Shape::star: return "star";
+    case Shape::comb: return "comb";
+    }
+    return "";
+}
+
+Points
+star_polygon (const std::size_t count_points) {
+    Points points = place_points_around_circle (1., count_points);
+    for (std::size_t i = 1; i < count_points; i += 2) {
+        points[i] = Point{points[i].x * 0.05, points[i].y * 0.05};
+    }
+    return points;
+}
+
+Points
+comb_polygon (const std::size_t count_points) {
+    const std::size_t count_teeth = (count_points - 2) / 4;
+    const double      height      = 10.;
+
+    Points points{{0., -1.}, {2. * count_teeth, -1.}};
+    for (std::size_t k = count_teeth; k-- > 0;) {
+        points.push_back ({2. * k + 1., 0.});
+        points.push_back ({2. * k + 1., height});
+        points.push_back ({2. * k, height});
+        points.push_back ({2. * k, 0.});
+    }
+    return points;
+}
+
+// Points of the shape with about `count_points` vertices, closed, i.e., the
+// first point is repeated at the end. Generated once for each shape and size.
+const Points&
+shape_points (const Shape shape, const std::size_t count_points) {
+    static std::map<std::pair<Shape, std::size_t>, Points> cache;
+
+    auto [it, inserted] = cache.try_emplace ({shape, count_points});
+    if (inserted) {
+        Points& points = it->second;
+        switch (shape) {
+        case Shape::regular: points = place_points_around_circle (5., count_points); break;
+        case Shape::random: points = random_polygon (count_points); break;
+        case Shape::star: points = star_polygon (count_points); break;
+        case Shape::comb: points = comb_polygon (count_points); break;
+        }
+        points.push_back (points.front());
+    }
+    return it->second;
+}
+
+std::string
+temp_filename (const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+//// Benchmarks
+//
+// The argument of every benchmark is the number of vertices.
+
+void
+bm_polygon (benchmark::State& state, const Shape shape, const Polygon::WindingMethod method) {
+    const Points& points = shape_points (shape, state.range (0));
+
+    for (auto _ : state) {
+        Points  copy = points;
+        Polygon polygon{std::move (copy), method};
+        benchmark::DoNotOptimize (polygon);
+    }
+    state.SetComplexityN (points.size() - 1);
+}
+
+// The pass of Polygon::metrics(), which keeps the result after the first call
+void
+bm_polygon_metrics (benchmark::State& state, const Shape shape) {
+    const Points& points = shape_points (shape, state.range (0));
+
+    for (auto _ : state) {
+        const PolygonMetrics metrics = geometry::polygon_metrics (points);
+        benchmark::DoNotOptimize (metrics);
+    }
+    state.SetComplexityN (points.size() - 1);
+}
+
+void
+bm_triangulate (benchmark::State& state, const Shape shape, const Algorithm algorithm) {
+    const Points& points = shape_points (shape, state.range (0));
+
+    Points                     copy = points;
+    const Polygon              polygon{std::move (copy)};
+    const TriangulationOptions options{.algorithm = algorithm};
+
+    for (auto _ : state) {
+        const Triangulation result = polygon.triangulation (options);
+        benchmark::DoNotOptimize (result.area);
+    }
+    state.SetComplexityN (points.size() - 1);
+}
+
+// Every iteration finds the polygon in the cache, i.e., hashes the points and
+// compares them with those of the entry, and copies the triangles.
+void
+bm_triangulate_cached (benchmark::State& state, const Shape shape) {
+    const Points& points = shape_points (shape, state.range (0));
+
+    Points                     copy = points;
+    const Polygon              polygon{std::move (copy)};
+    TriangulationCache         cache{std::size_t{1} << 30};
+    const TriangulationOptions options{.cache = &cache};
+    polygon.triangulation (options);
+
+    for (auto _ : state) {
+        const Triangulation result = polygon.triangulation (options);
+        benchmark::DoNotOptimize (result.area);
+    }
+    state.SetComplexityN (points.size() - 1);
+}
+
+// Every iteration moves a vertex off its place by a tenth of the edge after it,
+// and back, so the polygon stays the same.
+void
+bm_incremental_move (benchmark::State& state, const Shape shape) {
+    const Points&     points         = shape_points (shape, state.range (0));
+    const std::size_t count_vertices = points.size() - 1;
+
+    IncrementalTriangulation mesh{points};
+
+    std::size_t v = 0;
+    for (auto _ : state) {
+        const Point& p = points[v];
+        const Point& q = points[v + 1];
+        mesh.move_vertex (v, Point{p.x + .1 * (q.y - p.y), p.y - .1 * (q.x - p.x)});
+        mesh.move_vertex (v, p);
+        v = (v + 7) % count_vertices;
+    }
+    state.SetComplexityN (count_vertices);
+    state.counters["rebuilds"] = static_cast<double> (mesh.count_rebuilds());
+}
+
+// Every iteration inserts a vertex at the middle of an edge, which keeps any
+// simple polygon simple, and removes it.
+void
+bm_incremental_insert (benchmark::State& state, const Shape shape) {
+    const Points&     points         = shape_points (shape, state.range (0));
+    const std::size_t count_vertices = points.size() - 1;
+
+    IncrementalTriangulation mesh{points};
+
+    std::size_t v = 0;
+    for (auto _ : state) {
+        const Point p = geometry::midpoint (points[v], points[v + 1]);
+        mesh.remove_vertex (mesh.insert_vertex (v, p));
+        v = (v + 7) % count_vertices;
+    }
+    state.SetComplexityN (count_vertices);
+    state.counters["rebuilds"] = static_cast<double> (mesh.count_rebuilds());
+}
+
+void
+bm_read_csv_points (benchmark::State& state, const Shape shape) {
+    const Points&     points   = shape_points (shape, state.range (0));
+    const std::string filename = temp_filename ("bench_read_csv_points.csv");
+    fileio::write_points_csv_file (points, filename);
+
+    for (auto _ : state) {
+        const Points read = fileio::read_csv_points (filename);
+        benchmark::DoNotOptimize (read.data());
+    }
+    state.SetComplexityN (points.size() - 1);
+    std::filesystem::remove (filename);
+}
+
+void
+bm_write_tex_tikz (benchmark::State& state, const Shape shape) {
+    const Points&     points   = shape_points (shape, state.range (0));
+    const std::string filename = temp_filename ("bench_write_tex_tikz.tex");
+
+    Points              copy = points;
+    const Polygon       polygon{std::move (copy)};
+    const Triangulation result = polygon.triangulation();
+
+    for (auto _ : state) {
+        fileio::write_tex_tikz (filename, points, result.triangles, result.area, 1.);
+    }
+    state.SetComplexityN (points.size() - 1);
+    std::filesystem::remove (filename);
+}
+
+void
+bm_random_polygon (benchmark::State& state) {
+    for (auto _ : state) {
+        const Points points = random_polygon (state.range (0));
+        benchmark::DoNotOptimize (points.data());
+    }
+    state.SetComplexityN (state.range (0));
+}
+
+//// Registration
+
+// Sizes of the polygons in polygons/regular_polygon_<n>.csv
+constexpr std::size_t min_corpus_size = 10;
+constexpr std::size_t max_corpus_size = 1280;
+
+// Larger polygons to see the trend beyond the corpus
+constexpr std::size_t max_large_size = 20480;
+
+void
+register_benchmarks (const std::size_t max_random_size) {
+    using benchmark::RegisterBenchmark;
+
+    // The sizes of the corpus, 10, 20, 40, ..., and doubling beyond
+    const auto sizes = [] (benchmark::internal::Benchmark* b, const std::size_t max_size) {
+        for (std::size_t n = min_corpus_size; n <= max_size; n *= 2) b->Arg (n);
+        b->Complexity();
+    };
+
+    // Polygon construction, i.e., winding detection
+    for (const Shape shape : {Shape::regular, Shape::random, Shape::star, Shape::comb}) {
+        const std::size_t max_size = shape == Shape::random ? max_random_size : max_large_size;
+        const std::string name     = shape_name (shape);
+
+        sizes (
+            RegisterBenchmark (
+                ("polygon/signed_area/" + name).c_str(),
+                bm_polygon,
+                shape,
+                Polygon::WindingMethod::signed_area
+            ),
+            max_size
+        );
+        sizes (
+            RegisterBenchmark (
+                ("polygon/ray_casting/" + name).c_str(),
+                bm_polygon,
+                shape,
+                Polygon::WindingMethod::ray_casting
+            ),
+            std::min (max_size, max_corpus_size)
+        );
+        sizes (
+            RegisterBenchmark (("polygon/metrics/" + name).c_str(), bm_polygon_metrics, shape),
+            max_size
+        );
+    }
+
+    // Triangulation
+    for (const Shape shape : {Shape::regular, Shape::random, Shape::star, Shape::comb}) {
+        const std::size_t max_size = shape == Shape::random ? max_random_size : max_large_size;
+        const std::string name     = shape_name (shape);
+
+        sizes (
+            RegisterBenchmark (
+                ("triangulate/ear_clipping/" + name).c_str(),
+                bm_triangulate,
+                shape,
+                Algorithm::ear_clipping
+            ),
+            max_size
+        );
+        sizes (
+            RegisterBenchmark (
+                ("triangulate/monotone/" + name).c_str(), bm_triangulate, shape, Algorithm::monotone
+            ),
+            max_size
+        );
+        sizes (
+            RegisterBenchmark (("triangulate/cached/" + name).c_str(), bm_triangulate_cached, shape),
+            max_size
+        );
+    }
+
+    // Edits of a triangulation kept up to date. Moves are benchmarked only on
+    // the regular polygons, which they keep simple.
+    sizes (
+        RegisterBenchmark ("incremental/move/regular", bm_incremental_move, Shape::regular),
+        max_large_size
+    );
+    for (const Shape shape : {Shape::regular, Shape::random, Shape::star, Shape::comb}) {
+        const std::size_t max_size = shape == Shape::random ? max_random_size : max_large_size;
+        sizes (
+            RegisterBenchmark (
+                ("incremental/insert/" + shape_name (shape)).c_str(), bm_incremental_insert, shape
+            ),
+            max_size
+        );
+    }
+
+    // File input and output
+    sizes (
+        RegisterBenchmark ("read_csv_points/regular", bm_read_csv_points, Shape::regular),
+        max_large_size
+    );
+    sizes (
+        RegisterBenchmark ("write_tex_tikz/regular", bm_write_tex_tikz, Shape::regular),
+        max_large_size
+    );
+
+    // Generator of random polygons
+    sizes (RegisterBenchmark ("random_polygon", bm_random_polygon), max_random_size);
+}
+
+}  // namespace
+
+//// main
+int
+main (int argc, char* argv[]) {
+    benchmark::Initialize (&argc, argv);
+
+    // Flags not recognized by Google Benchmark are left in argv.
+    std::size_t max_random_size = max_large_size;
+    for (int i = 1; i < argc; ++i) {
+        constexpr std::string_view flag{"--max_random_size="};
+        const std::string_view     arg{argv[i]};
+        if (arg.starts_with (flag)) {
+            max_random_size = std::strtoull (arg.data() + flag.size(), nullptr, 10);
+        } else {
+            std::cerr << argv[0] << ": unrecognized argument '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    register_benchmarks (max_random_size);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
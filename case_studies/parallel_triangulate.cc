@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/polygon.h"
+#include "core/random.h"
+#include "core/thread_pool.h"
+
+// Place points around a circle at random distances from the center, which
+// makes a star-shaped polygon with many monotone pieces.
+std::vector<Point>
+random_star (const int count_points) {
+    random_float_gen<double> random{0.2, 1.2};
+    const double             inc = 2. * std::numbers::pi / count_points;
+
+    std::vector<Point> points;
+    points.reserve (count_points + 1);
+    for (int i = 0; i < count_points; ++i) {
+        const double r = random();
+        points.push_back (Point{r * std::cos (i * inc), r * std::sin (i * inc)});
+    }
+    points.push_back (points.front());
+
+    return points;
+}
+
+// Average time to triangulate in milliseconds
+double
+time_triangulation (const Polygon& poly, ThreadPool* pool) {
+    constexpr int repeats = 5;
+
+    // Warm up the allocator and the caches.
+    poly.triangulate ({.algorithm = Algorithm::monotone, .pool = pool});
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        poly.triangulate ({.algorithm = Algorithm::monotone, .pool = pool});
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / repeats;
+}
+
+//// main
+//
+// Usage: parallel_triangulate [number of vertices] [maximum number of threads]
+int
+main (int argc, char* argv[]) {
+    const int      count_points = argc > 1 ? std::stoi (argv[1]) : 1000000;
+    const unsigned max_threads  = argc > 2 ? std::stoul (argv[2])
+                                           : std::max (1u, std::thread::hardware_concurrency());
+    Polygon        poly{random_star (count_points)};
+
+    const double serial = time_triangulation (poly, nullptr);
+    std::cout << count_points << " vertices\n";
+    std::cout << "threads  time (ms)  speedup\n";
+    std::cout << std::setw (7) << "serial" << std::setw (11) << std::fixed << std::setprecision (1)
+              << serial << std::setw (9) << std::setprecision (2) << 1.0 << '\n';
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool   pool{threads};
+        const double parallel = time_triangulation (poly, &pool);
+        std::cout << std::setw (7) << threads << std::setw (11) << std::setprecision (1)
+                  << parallel << std::setw (9) << std::setprecision (2) << serial / parallel
+                  << '\n';
+    }
+}
@@ -1,8 +1,16 @@
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
 #include <string>
 
 #include "core/fileio.h"
 #include "core/polygon.h"
+#include "core/stream.h"
+#include "core/tikz_progress.h"
+
+// Draw every step of the triangulation if true (--progress)
+bool draw_progress = false;
 
 // Triangulate
 void
@@ -10,19 +18,77 @@ triangulate (const std::string& dir, std::string filename_ext, const double scal
   auto    points = fileio::read_csv_points (dir + "/" + filename_ext);
   Polygon poly{std::move (points)};
 
-  Triangles    triangles = poly.triangulate();
-  const double area      = poly.area();
-
-  std::cout << "Area = " << area << '\n';
-
   const std::string ext{".csv"};
   std::string       filename = filename_ext.erase (filename_ext.size() - ext.size());
-  fileio::write_tex_tikz ("polygons/output/" + filename + ".tex", points, triangles, area, scale);
+
+  std::optional<TikzProgressObserver> progress;
+  if (draw_progress) progress.emplace ("polygons/output/" + filename + "_progress.tex", 0.25);
+
+  const Triangulation result = poly.triangulation ({.observer = progress ? &*progress : nullptr});
+
+  std::cout << "Area = " << poly.area() << '\n';
+  if (!poly.covers (result)) {
+    std::cout << "Warning: the triangles cover an area of " << result.area
+              << "; the polygon may not be simple\n";
+  }
+
+  fileio::write_tex_tikz (
+      "polygons/output/" + filename + ".tex", poly.points(), result.triangles, poly.area(), scale
+  );
+}
+
+// Triangulate the polygons in a CSV file, or the standard input if "-",
+// separated by empty lines, and write the triangles of each polygon to the
+// standard output, one "i, j, k" per line, followed by an empty line.
+void
+triangulate_csv_stream (const std::string& filename) {
+  std::ifstream file;
+  if (filename != "-") {
+    file.open (filename, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error ("Failed to open file: " + filename);
+  }
+
+  fileio::CsvPolygonReader reader{filename == "-" ? std::cin : file};
+
+  std::string       text;
+  double            area            = 0.;
+  std::size_t       count_triangles = 0;
+  const std::size_t count_polygons  = triangulate_stream (
+      [&] { return reader.next(); },
+      [&] (const Triangulation& result) {
+        text.clear();
+        for (const auto& tri : result.triangles) {
+          text += std::to_string (tri[0]) + ", " + std::to_string (tri[1]) + ", " +
+                  std::to_string (tri[2]) + '\n';
+        }
+        text += '\n';
+        std::cout << text;
+
+        area += result.area;
+        count_triangles += result.triangles.size();
+      },
+      {.triangulation = {.algorithm = Algorithm::monotone}}
+  );
+
+  std::cerr << count_polygons << " polygons, " << count_triangles << " triangles, area = " << area
+            << '\n';
 }
 
 //// main
 int
 main (int argc, char* argv[]) {
+  std::ios::sync_with_stdio (false);
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::string{argv[i]} == "--progress") draw_progress = true;
+
+    // Triangulate a stream of polygons instead of the example files.
+    if (std::string{argv[i]} == "--stream") {
+      triangulate_csv_stream (i + 1 < argc ? argv[i + 1] : "-");
+      return 0;
+    }
+  }
+
   triangulate ("polygons", "regular_polygon_10.csv", 1.0);
   triangulate ("polygons", "regular_polygon_20.csv", 1.0);
   triangulate ("polygons", "regular_polygon_40.csv", 1.0);
@@ -0,0 +1,56 @@
+#include "core/batch.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "core/triangulator.h"
+
+std::vector<Triangulation>
+triangulate_batch (
+    std::span<const PolygonView> polygons,
+    ThreadPool&                  pool,
+    const TriangulationOptions&  options
+) {
+    if (options.observer) {
+        throw std::invalid_argument ("An observer cannot be shared by a batch triangulation");
+    }
+
+    // The time to triangulate grows with the number of vertices, so it is used
+    // as the cost of a polygon.
+    std::vector<std::size_t> order (polygons.size());
+    std::iota (order.begin(), order.end(), 0);
+    std::stable_sort (order.begin(), order.end(), [&] (const std::size_t i, const std::size_t j) {
+        return polygons[i].size() > polygons[j].size();
+    });
+
+    // One task per polygon, dealt to the threads in the order, and stolen by
+    // the threads running out of them. Every thread triangulates with a
+    // triangulator of its own, whose workspace is reused from polygon to
+    // polygon, and from batch to batch.
+    std::vector<Triangulation> results (polygons.size());
+    pool.for_each (order.size(), [&] (const std::size_t k) {
+        thread_local Triangulator triangulator;
+
+        const std::size_t idx = order[k];
+        results[idx]          = triangulator.triangulate (polygons[idx], options);
+    });
+
+    return results;
+}
+
+std::vector<Triangulation>
+triangulate_batch (
+    std::span<const Polygon>    polygons,
+    ThreadPool&                 pool,
+    const TriangulationOptions& options
+) {
+    std::vector<PolygonView> views;
+    views.reserve (polygons.size());
+    for (const Polygon& polygon : polygons) views.push_back (polygon.view());
+
+    return triangulate_batch (views, pool, options);
+}
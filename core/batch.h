@@ -0,0 +1,41 @@
+//
+// batch.h
+//
+// Triangulate many polygons in parallel
+//
+
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <span>
+#include <vector>
+
+#include "core/polygon.h"
+#include "core/thread_pool.h"
+
+// Triangulate every polygon with the threads of the pool, and return the
+// results in the order of the polygons.
+//
+// The polygons are handed out from the largest one, so that a large polygon
+// coming last does not keep one thread busy while the others are idle. Every
+// thread keeps a Triangulator, whose workspace is reused by the next batches
+// too, so it holds the memory for the largest polygon it triangulated.
+//
+// NOTE: an observer in the options would be called from several threads at
+// the same time, so it is not allowed (std::invalid_argument).
+std::vector<Triangulation>
+triangulate_batch (
+    std::span<const PolygonView> polygons,
+    ThreadPool&                  pool,
+    const TriangulationOptions&  options = {}
+);
+
+// Same as above, over polygons owning their points
+std::vector<Triangulation>
+triangulate_batch (
+    std::span<const Polygon>    polygons,
+    ThreadPool&                 pool,
+    const TriangulationOptions& options = {}
+);
+
+#endif
@@ -0,0 +1,339 @@
+#include "core/cache.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/endian.h"
+#include "core/fileio.h"
+
+namespace {
+
+//// Cache files
+//
+// A cache file holds the polygons from the most recently used one, all in
+// little-endian:
+//
+//   offset  size        contents
+//   0       8           magic "TRICACHE"
+//   8       4           version (uint32, 1)
+//   12      4           reserved (0)
+//   16      8           number of polygons n (uint64)
+//   24      ...         n polygons, each of
+//           1             type of the coordinates
+//           1             algorithm
+//           1             ear order
+//           1             bytes of a vertex index w (2, 4 or 8)
+//           4             reserved (0)
+//           8             number of vertices v (uint64)
+//           8             number of triangles m (uint64)
+//           8             area (double)
+//           16 * v        points relative to the first vertex (double x, double y)
+//           3 * w * m     vertex indices of the triangles (unsigned)
+//
+// The vertex indices are in the narrowest width which can hold them, as in
+// the mesh files (see fileio::mesh_index_size).
+
+constexpr std::string_view cache_magic{"TRICACHE", 8};
+constexpr std::uint32_t    cache_version       = 1;
+constexpr std::size_t      cache_header_size   = 24;
+constexpr std::size_t      polygon_header_size = 32;
+
+// Bytes of a polygon in the cache
+std::size_t
+bytes_of (const std::size_t count_points, const std::size_t count_triangles) {
+    return sizeof (Point) * count_points + sizeof (TriangleSpec) * count_triangles;
+}
+
+// Mix a word into the hash with a multiplication and a rotation, which is
+// fast enough not to show next to the comparison of the points on a hit.
+std::uint64_t
+mix (const std::uint64_t hash, const std::uint64_t word) {
+    return std::rotl ((hash ^ word) * 0x9e3779b97f4a7c15, 27);
+}
+
+// Finalize the hash, so that every bit of the words changes the low bits too
+// (the finalizer of MurmurHash3).
+std::uint64_t
+finalize (std::uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// The points are compared bit by bit, as they are hashed.
+bool
+same_points (const std::span<const Point> a, const std::span<const Point> b) {
+    return std::equal (a.begin(), a.end(), b.begin(), b.end(), [] (const Point& p, const Point& q) {
+        return std::bit_cast<std::uint64_t> (p.x) == std::bit_cast<std::uint64_t> (q.x) &&
+               std::bit_cast<std::uint64_t> (p.y) == std::bit_cast<std::uint64_t> (q.y);
+    });
+}
+
+template <typename Index>
+void
+write_indices (std::ostream& os, const Triangles& triangles) {
+    for (const auto& tri : triangles) {
+        for (const std::size_t idx : tri) write_little_endian (os, static_cast<Index> (idx));
+    }
+}
+
+}  // namespace
+
+//// class TriangulationCache
+
+TriangulationCache::TriangulationCache (const std::size_t capacity)
+    : _capacity{capacity} {}
+
+std::size_t
+TriangulationCache::size () const {
+    std::lock_guard lock (_mutex);
+    return _entries.size();
+}
+
+std::size_t
+TriangulationCache::bytes () const {
+    std::lock_guard lock (_mutex);
+    return _bytes;
+}
+
+std::size_t
+TriangulationCache::count_hits () const {
+    std::lock_guard lock (_mutex);
+    return _count_hits;
+}
+
+std::size_t
+TriangulationCache::count_misses () const {
+    std::lock_guard lock (_mutex);
+    return _count_misses;
+}
+
+void
+TriangulationCache::clear () {
+    std::lock_guard lock (_mutex);
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+TriangulationCache::Key
+TriangulationCache::make_key (
+    const std::span<const Point> shape,
+    const std::uint8_t           coordinates,
+    const Algorithm              algorithm,
+    const EarOrder               ear_order
+) {
+    Key key{shape, coordinates, algorithm, ear_order};
+
+    std::uint64_t hash = mix (shape.size(), coordinates);
+    hash               = mix (hash, static_cast<std::uint64_t> (algorithm));
+    hash               = mix (hash, static_cast<std::uint64_t> (ear_order));
+    for (const Point& p : shape) {
+        hash = mix (hash, std::bit_cast<std::uint64_t> (p.x));
+        hash = mix (hash, std::bit_cast<std::uint64_t> (p.y));
+    }
+    key.hash = finalize (hash);
+
+    return key;
+}
+
+bool
+TriangulationCache::find (const Key& key, Triangulation& result) {
+    EntryPtr entry;
+    {
+        std::lock_guard lock (_mutex);
+        const auto      it = _index.find (key.hash);
+        if (it != _index.end()) {
+            const Key& found = (*it->second)->key;
+            if (found.coordinates == key.coordinates && found.algorithm == key.algorithm &&
+                found.ear_order == key.ear_order && same_points (found.shape, key.shape)) {
+                entry = *it->second;
+                _entries.splice (_entries.begin(), _entries, it->second);
+            }
+        }
+        if (entry) {
+            _count_hits++;
+        } else {
+            _count_misses++;
+            return false;
+        }
+    }
+
+    // The entry is kept alive by the pointer, even if it is dropped meanwhile.
+    result.triangles.assign (
+        entry->triangulation.triangles.begin(), entry->triangulation.triangles.end()
+    );
+    result.area = entry->triangulation.area;
+    return true;
+}
+
+void
+TriangulationCache::insert (const Key& key, const Triangulation& triangulation) {
+    if (bytes_of (key.shape.size(), triangulation.triangles.size()) > _capacity) return;
+
+    auto entry = std::make_shared<Entry> (
+        Entry{key, Points (key.shape.begin(), key.shape.end()), triangulation}
+    );
+    entry->key.shape = entry->points;
+
+    std::lock_guard lock (_mutex);
+    insert_locked (std::move (entry));
+}
+
+void
+TriangulationCache::insert_locked (EntryPtr entry) {
+    // Another entry of the same hash, either the same polygon triangulated by
+    // another thread meanwhile or a collision, is replaced.
+    if (const auto it = _index.find (entry->key.hash); it != _index.end()) {
+        const Entry& old = **it->second;
+        _bytes -= bytes_of (old.points.size(), old.triangulation.triangles.size());
+        _entries.erase (it->second);
+        _index.erase (it);
+    }
+
+    _bytes += bytes_of (entry->points.size(), entry->triangulation.triangles.size());
+    _entries.push_front (std::move (entry));
+    _index[_entries.front()->key.hash] = _entries.begin();
+
+    while (_bytes > _capacity) {
+        const Entry& last = *_entries.back();
+        _bytes -= bytes_of (last.points.size(), last.triangulation.triangles.size());
+        _index.erase (last.key.hash);
+        _entries.pop_back();
+    }
+}
+
+void
+TriangulationCache::save (const std::string& filename) const {
+    std::ofstream file (filename, std::ios::binary);
+    if (!file) throw std::runtime_error ("Failed to open file: " + filename);
+
+    std::lock_guard lock (_mutex);
+
+    file.write (cache_magic.data(), cache_magic.size());
+    write_little_endian<std::uint32_t> (file, cache_version);
+    write_little_endian<std::uint32_t> (file, 0);
+    write_little_endian<std::uint64_t> (file, _entries.size());
+
+    for (const EntryPtr& entry : _entries) {
+        const std::size_t count_vertices = entry->points.size();
+        const std::size_t index_size     = fileio::mesh_index_size (count_vertices);
+        const Triangles&  triangles      = entry->triangulation.triangles;
+
+        write_little_endian (file, entry->key.coordinates);
+        write_little_endian (file, static_cast<std::uint8_t> (entry->key.algorithm));
+        write_little_endian (file, static_cast<std::uint8_t> (entry->key.ear_order));
+        write_little_endian (file, static_cast<std::uint8_t> (index_size));
+        write_little_endian<std::uint32_t> (file, 0);
+        write_little_endian<std::uint64_t> (file, count_vertices);
+        write_little_endian<std::uint64_t> (file, triangles.size());
+        write_little_endian (file, entry->triangulation.area);
+
+        for (const Point& p : entry->points) {
+            write_little_endian (file, p.x);
+            write_little_endian (file, p.y);
+        }
+
+        switch (index_size) {
+        case 2: write_indices<std::uint16_t> (file, triangles); break;
+        case 4: write_indices<std::uint32_t> (file, triangles); break;
+        default: write_indices<std::uint64_t> (file, triangles); break;
+        }
+    }
+
+    if (!file) throw std::runtime_error ("Failed to write file: " + filename);
+}
+
+void
+TriangulationCache::load (const std::string& filename) {
+    const fileio::MappedFile mapped (filename);
+    const std::string_view   data    = mapped.view();
+    const auto               invalid = [&filename] () {
+        return std::runtime_error ("Invalid cache file: " + filename);
+    };
+
+    if (data.size() < cache_header_size || !data.starts_with (cache_magic) ||
+        read_little_endian<std::uint32_t> (data.data() + 8) != cache_version)
+        throw invalid();
+
+    // Every polygon is read and checked before any is added to the cache.
+    const std::uint64_t   count_polygons = read_little_endian<std::uint64_t> (data.data() + 16);
+    std::vector<EntryPtr> entries;
+    std::size_t           position = cache_header_size;
+    for (std::uint64_t i = 0; i < count_polygons; ++i) {
+        if (data.size() - position < polygon_header_size) throw invalid();
+        const char* header = data.data() + position;
+
+        const auto coordinates = static_cast<std::uint8_t> (header[0]);
+        const auto algorithm   = static_cast<std::uint8_t> (header[1]);
+        const auto ear_order   = static_cast<std::uint8_t> (header[2]);
+        const auto index_size  = static_cast<std::uint8_t> (header[3]);
+        if (algorithm > static_cast<std::uint8_t> (Algorithm::monotone) ||
+            ear_order > static_cast<std::uint8_t> (EarOrder::quality) ||
+            (index_size != 2 && index_size != 4 && index_size != 8))
+            throw invalid();
+
+        const std::uint64_t count_vertices  = read_little_endian<std::uint64_t> (header + 8);
+        const std::uint64_t count_triangles = read_little_endian<std::uint64_t> (header + 16);
+        position += polygon_header_size;
+
+        // The points and the indices must fit in the file.
+        const std::size_t remaining = data.size() - position;
+        if (count_vertices > remaining / sizeof (Point) ||
+            count_triangles > (remaining - sizeof (Point) * count_vertices) / (3 * index_size))
+            throw invalid();
+
+        auto entry = std::make_shared<Entry>();
+        entry->triangulation.area = read_little_endian<double> (header + 24);
+
+        entry->points.resize (count_vertices);
+        for (Point& p : entry->points) {
+            p.x = read_little_endian<double> (data.data() + position);
+            p.y = read_little_endian<double> (data.data() + position + 8);
+            position += sizeof (Point);
+        }
+
+        entry->triangulation.triangles.resize (count_triangles);
+        for (auto& tri : entry->triangulation.triangles) {
+            for (std::size_t& idx : tri) {
+                const char* in = data.data() + position;
+                switch (index_size) {
+                case 2: idx = read_little_endian<std::uint16_t> (in); break;
+                case 4: idx = read_little_endian<std::uint32_t> (in); break;
+                default: idx = read_little_endian<std::uint64_t> (in); break;
+                }
+                if (idx >= count_vertices) throw invalid();
+                position += index_size;
+            }
+        }
+
+        entry->key = make_key (
+            entry->points,
+            coordinates,
+            static_cast<Algorithm> (algorithm),
+            static_cast<EarOrder> (ear_order)
+        );
+        entries.push_back (std::move (entry));
+    }
+
+    // From the least recently used, so that the order is kept.
+    std::lock_guard lock (_mutex);
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        const Entry& entry = **it;
+        if (bytes_of (entry.points.size(), entry.triangulation.triangles.size()) <= _capacity)
+            insert_locked (std::move (*it));
+    }
+}
@@ -0,0 +1,138 @@
+//
+// cache.h
+//
+// Cache of the triangulations of polygons triangulated before
+//
+
+#ifndef __CACHE_H__
+#define __CACHE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "core/polygon.h"
+
+//// class TriangulationCache
+
+// Triangulations of the polygons seen before, for the workloads which
+// triangulate the same outlines over and over, e.g., building footprints,
+// glyphs and standard parts. Given in TriangulationOptions, a polygon found
+// in the cache costs a hash of its points and a comparison with the entry,
+// instead of a triangulation.
+//
+// A polygon is identified by its points relative to the first vertex, so a
+// translated copy of a polygon is found as well, if the differences of the
+// coordinates are exact in double, e.g., a footprint moved on a grid. The
+// triangles are then those of the first copy, and valid for the translated
+// one, since the two are congruent exactly. So is the area, up to the
+// rounding of the first copy.
+//
+// The cache holds at most `capacity` bytes of points and triangles, and drops
+// the least recently used polygons first. It is thread-safe, so one cache can
+// be shared by the threads of triangulate_batch.
+class TriangulationCache {
+  public:
+    explicit TriangulationCache (const std::size_t capacity);
+
+    TriangulationCache (const TriangulationCache&)            = delete;
+    TriangulationCache& operator= (const TriangulationCache&) = delete;
+
+    // Number of polygons in the cache
+    std::size_t
+    size () const;
+
+    // Bytes of the points and the triangles in the cache
+    std::size_t
+    bytes () const;
+
+    std::size_t
+    capacity () const {
+        return _capacity;
+    }
+
+    // Number of lookups which found the polygon, and which did not
+    std::size_t
+    count_hits () const;
+
+    std::size_t
+    count_misses () const;
+
+    void
+    clear ();
+
+    // Write the polygons in the cache into a file, and read them back, e.g.,
+    // to keep the cache from run to run. Loading adds the polygons to those in
+    // the cache. Throws std::runtime_error if the file cannot be written, or
+    // is not a valid cache file (see cache.cc for the format).
+    void
+    save (const std::string& filename) const;
+
+    void
+    load (const std::string& filename);
+
+  private:
+    template <typename> friend class BasicPolygonView;
+
+    // Code of the coordinate type T: its size, and whether it is an integer
+    template <typename T>
+    static constexpr std::uint8_t coordinates_code =
+        (std::is_integral_v<T> ? 0x10 : 0) | static_cast<std::uint8_t> (sizeof (T));
+
+    // Polygon to look up: its points relative to the first vertex, and what
+    // else changes the triangles
+    struct Key {
+        std::span<const Point> shape;
+        std::uint8_t           coordinates;  // Type of the coordinates
+        Algorithm              algorithm;
+        EarOrder               ear_order;
+        std::uint64_t          hash = 0;
+    };
+
+    struct Entry {
+        Key           key;  // Whose shape refers to the points
+        Points        points;
+        Triangulation triangulation;
+    };
+
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    static Key
+    make_key (
+        const std::span<const Point> shape,
+        const std::uint8_t           coordinates,
+        const Algorithm              algorithm,
+        const EarOrder               ear_order
+    );
+
+    // Copy the triangulation of the polygon into `result`, if in the cache.
+    bool
+    find (const Key& key, Triangulation& result);
+
+    void
+    insert (const Key& key, const Triangulation& triangulation);
+
+    // Insert an entry as the most recently used, and drop the least recently
+    // used ones beyond the capacity. The mutex should be locked.
+    void
+    insert_locked (EntryPtr entry);
+
+    using Entries = std::list<EntryPtr>;
+
+    const std::size_t _capacity;
+
+    mutable std::mutex                                   _mutex;
+    Entries                                              _entries;  // Most recent first
+    std::unordered_map<std::uint64_t, Entries::iterator> _index;    // By the hash
+    std::size_t                                          _bytes        = 0;
+    std::size_t                                          _count_hits   = 0;
+    std::size_t                                          _count_misses = 0;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "core/ear_queue.h"
+
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+EarQueue::EarQueue (const EarOrder order, std::pmr::memory_resource* resource)
+    : _order{order}
+    , _fifo{resource}
+    , _ranked{std::less<RankedEntry>{}, std::pmr::vector<RankedEntry>{resource}} {}
+
+bool
+EarQueue::empty () const {
+    return _order == EarOrder::fifo ? _fifo.empty() : _ranked.empty();
+}
+
+// Push an ear. The quality is used only when the order is EarOrder::quality,
+// and the ear with the highest quality is popped first.
+void
+EarQueue::push (const std::size_t idx, const std::uint32_t version, const double quality) {
+    if (_order == EarOrder::fifo) {
+        _fifo.push_back (Entry{idx, version});
+    } else {
+        _ranked.push (RankedEntry{quality, Entry{idx, version}});
+    }
+}
+
+std::optional<EarQueue::Entry>
+EarQueue::pop () {
+    if (empty()) return std::nullopt;
+
+    Entry entry;
+    if (_order == EarOrder::fifo) {
+        entry = _fifo.front();
+        _fifo.pop_front();
+    } else {
+        entry = _ranked.top().entry;
+        _ranked.pop();
+    }
+    return entry;
+}
+
+void
+EarQueue::clear () {
+    _fifo.clear();
+    _ranked = {};
+}
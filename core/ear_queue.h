@@ -0,0 +1,73 @@
+//
+// ear_queue.h
+//
+// Work queue of the ears to be clipped during triangulation
+//
+
+#ifndef __EAR_QUEUE_H__
+#define __EAR_QUEUE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <vector>
+
+//// Enum: EarOrder
+
+// .fifo: clip the ears in the order they are found
+// .quality: clip the ear with the best quality (e.g., the largest smallest
+//   angle) first, which avoids thin triangles
+enum class EarOrder { fifo, quality };
+
+//// class EarQueue
+
+// A vertex may be pushed several times as it is classified again. Each entry
+// carries the version of the classification at the time it was pushed, so the
+// caller can discard the entries which became stale.
+class EarQueue {
+  public:
+    struct Entry {
+        std::size_t   idx;
+        std::uint32_t version;
+    };
+
+    // The entries are allocated from the memory resource.
+    explicit EarQueue (
+        const EarOrder             order    = EarOrder::fifo,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    );
+
+    bool
+    empty () const;
+
+    // Push an ear. The quality is used only when the order is EarOrder::quality,
+    // and the ear with the highest quality is popped first.
+    void
+    push (const std::size_t idx, const std::uint32_t version, const double quality = 0.);
+
+    std::optional<Entry>
+    pop ();
+
+    void
+    clear ();
+
+  private:
+    struct RankedEntry {
+        double quality;
+        Entry  entry;
+
+        bool
+        operator< (const RankedEntry& other) const {
+            return quality < other.quality;
+        }
+    };
+
+    EarOrder                                                        _order;
+    std::pmr::deque<Entry>                                          _fifo;
+    std::priority_queue<RankedEntry, std::pmr::vector<RankedEntry>> _ranked;
+};
+
+#endif
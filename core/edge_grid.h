@@ -0,0 +1,122 @@
+//
+// edge_grid.h
+//
+// Spatial hash to look up the edges of a polygon by location
+//
+
+#ifndef __EDGE_GRID_H__
+#define __EDGE_GRID_H__
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "core/primitive.h"
+
+//// class EdgeGrid
+
+// Spatial hash of the edges of a polygon whose points move. The plane is
+// divided into square cells, and an edge is kept in every cell overlapping its
+// bounding box. The cells are mapped to a fixed number of buckets by hashing,
+// so the grid covers the whole plane with memory proportional to the number
+// of edges. Cells sharing a bucket only add edges to be tested.
+class EdgeGrid {
+  public:
+    // The number of buckets is chosen for `count_edges` edges. More edges may
+    // be inserted later, which only makes the buckets longer.
+    EdgeGrid (const double cell_size, const std::size_t count_edges)
+        : _inv_cell_size{1. / cell_size}
+        , _buckets (std::bit_ceil (std::max<std::size_t> (2 * count_edges, 1)))
+        , _mask{_buckets.size() - 1} {}
+
+    void
+    insert (const std::size_t edge, const Point& p, const Point& q) {
+        for_each_bucket (p, q, [edge] (std::vector<std::size_t>& bucket) {
+            bucket.push_back (edge);
+        });
+    }
+
+    // Remove an edge. The end points should be those used to insert it.
+    void
+    remove (const std::size_t edge, const Point& p, const Point& q) {
+        for_each_bucket (p, q, [edge] (std::vector<std::size_t>& bucket) {
+            auto it = std::find (bucket.begin(), bucket.end(), edge);
+            if (it == bucket.end()) return;
+
+            *it = bucket.back();
+            bucket.pop_back();
+        });
+    }
+
+    // Call `pred` with every edge in the cells overlapping the bounding box of
+    // the line segment (p, q), until it returns true. Returns whether any of
+    // the calls returned true. An edge may be passed more than once.
+    template <typename Predicate>
+    bool
+    any_of (const Point& p, const Point& q, Predicate pred) const {
+        const auto [col_begin, col_end] = cells (p.x, q.x);
+        const auto [row_begin, row_end] = cells (p.y, q.y);
+
+        for (std::int64_t r = row_begin; r <= row_end; ++r) {
+            for (std::int64_t c = col_begin; c <= col_end; ++c) {
+                for (const std::size_t edge : _buckets[bucket (c, r)]) {
+                    if (pred (edge)) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+  private:
+    template <typename Function>
+    void
+    for_each_bucket (const Point& p, const Point& q, Function f) {
+        const auto [col_begin, col_end] = cells (p.x, q.x);
+        const auto [row_begin, row_end] = cells (p.y, q.y);
+
+        for (std::int64_t r = row_begin; r <= row_end; ++r) {
+            for (std::int64_t c = col_begin; c <= col_end; ++c) {
+                f (_buckets[bucket (c, r)]);
+            }
+        }
+    }
+
+    // First and last cells overlapping the interval between a and b
+    std::pair<std::int64_t, std::int64_t>
+    cells (const double a, const double b) const {
+        const auto [lower, upper] = std::minmax (a, b);
+        return {cell (lower), cell (upper)};
+    }
+
+    // floor (a / cell size), without calling std::floor
+    std::int64_t
+    cell (const double a) const {
+        const double       c = a * _inv_cell_size;
+        const std::int64_t i = static_cast<std::int64_t> (c);
+        return i - (c < i);
+    }
+
+    // The cells are hashed in blocks of 8 x 8, and the cells of a block are
+    // mapped to consecutive buckets, so that the cells next to each other are
+    // likely in the same cache lines.
+    std::size_t
+    bucket (const std::int64_t col, const std::int64_t row) const {
+        const auto block_col = static_cast<std::uint64_t> (col >> 3);
+        const auto block_row = static_cast<std::uint64_t> (row >> 3);
+
+        std::uint64_t h = block_col * 0x9e3779b97f4a7c15ull ^ block_row * 0xc2b2ae3d27d4eb4full;
+        h ^= h >> 32;
+        h = h << 6 | static_cast<std::uint64_t> ((row & 7) << 3 | (col & 7));
+        return static_cast<std::size_t> (h) & _mask;
+    }
+
+  private:
+    const double                          _inv_cell_size;
+    std::vector<std::vector<std::size_t>> _buckets;
+    const std::size_t                     _mask;
+};
+
+#endif
@@ -0,0 +1,45 @@
+//
+// endian.h
+//
+// Little-endian representation of the values in binary files
+//
+
+#ifndef __ENDIAN_H__
+#define __ENDIAN_H__
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <ostream>
+
+constexpr bool little_endian = std::endian::native == std::endian::little;
+
+// Convert a value between the native and the little-endian representations
+template <typename T>
+T
+swap_little_endian (T value) {
+    if constexpr (!little_endian) {
+        auto bytes = std::bit_cast<std::array<char, sizeof (T)>> (value);
+        std::reverse (bytes.begin(), bytes.end());
+        value = std::bit_cast<T> (bytes);
+    }
+    return value;
+}
+
+template <typename T>
+T
+read_little_endian (const char* data) {
+    T value;
+    std::memcpy (&value, data, sizeof (T));
+    return swap_little_endian (value);
+}
+
+template <typename T>
+void
+write_little_endian (std::ostream& os, const T value) {
+    const T swapped = swap_little_endian (value);
+    os.write (reinterpret_cast<const char*> (&swapped), sizeof (T));
+}
+
+#endif
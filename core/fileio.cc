@@ -1,46 +1,571 @@
 #include "core/fileio.h"
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "core/endian.h"
+#include "core/geometry.h"
+
+// Files are memory-mapped on POSIX systems.
+#if defined(__unix__) || defined(__APPLE__)
+#define TRIANGULATE_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 //// NAMESPACE: fileio
 
 namespace fileio {
 
+namespace {
+
+bool
+is_blank (const char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parse the number in the field [first, last), which may be surrounded by
+// blanks. Returns false if the field is not a number.
+bool
+parse_number (const char* first, const char* last, double& value) {
+    while (first < last && is_blank (*first)) ++first;
+    while (first < last && is_blank (*(last - 1))) --last;
+    if (first < last && *first == '+') ++first;
+    if (first == last) return false;
+
+#if defined(__cpp_lib_to_chars)
+    const auto [ptr, ec] = std::from_chars (first, last, value);
+    return ec == std::errc() && ptr == last;
+#else
+    // std::strtod needs a null-terminated string.
+    char buffer[64];
+    if (last - first >= static_cast<std::ptrdiff_t> (sizeof (buffer))) return false;
+    std::copy (first, last, buffer);
+    buffer[last - first] = '\0';
+
+    char* end;
+    value = std::strtod (buffer, &end);
+    return end == buffer + (last - first);
+#endif
+}
+
+// Shortest representation of a number which reads back to the same value
+void
+append_number (std::string& out, const double value) {
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::to_chars (buffer, buffer + sizeof (buffer), value);
+    out.append (buffer, result.ptr);
+#else
+    const int length = std::snprintf (buffer, sizeof (buffer), "%.17g", value);
+    out.append (buffer, static_cast<std::size_t> (length));
+#endif
+}
+
+// A number with `precision` significant digits, in the same form as an output
+// stream writes by default
+void
+append_number (std::string& out, const double value, const int precision) {
+    char buffer[64];
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::to_chars (
+        buffer, buffer + sizeof (buffer), value, std::chars_format::general, precision
+    );
+    out.append (buffer, result.ptr);
+#else
+    const int length = std::snprintf (buffer, sizeof (buffer), "%.*g", precision, value);
+    out.append (buffer, static_cast<std::size_t> (length));
+#endif
+}
+
+//// TikZ pictures
+
+// Appends the TikZ commands of a picture to a string. With the level of detail
+// of the options, the features smaller than the resolution are dropped.
+class TikzWriter {
+  public:
+    TikzWriter (std::string& out, const double scale, const TikzOptions& options)
+        : _out{out}
+        , _precision{std::clamp (options.precision, 1, 17)}
+        , _resolution{scale > 0. ? options.resolution / scale : 0.} {}
+
+    void
+    begin_picture (const double scale) {
+        _out += "\\tikzpicture[scale=";
+        append_number (_out, scale, 6);
+        _out += "]\n";
+    }
+
+    void
+    end_picture () {
+        _out += "\\endtikzpicture\n";
+    }
+
+    // Outline through the vertices given by vertex(), from begin_outline() to
+    // end_outline()
+    void
+    begin_outline () {
+        _out += "\\draw[thick]\n";
+        _count_drawn = 0;
+        _pending.reset();
+    }
+
+    void
+    vertex (const Point& p) {
+        if (_count_drawn > 0 && size (_last_drawn, p, p) < _resolution) {
+            // The last vertex is drawn even if it is too close.
+            _pending = p;
+            return;
+        }
+        draw_vertex (p);
+    }
+
+    void
+    end_outline () {
+        if (_pending) draw_vertex (*_pending);
+        _out += ";\n";
+    }
+
+    void
+    triangle (const Point& a, const Point& b, const Point& c) {
+        if (_resolution > 0. && size (a, b, c) < _resolution) return;
+
+        _out += "\\draw[ultra thin]";
+        point (a);
+        _out += " -- ";
+        point (b);
+        _out += " -- ";
+        point (c);
+        _out += " -- cycle;\n";
+    }
+
+  private:
+    // Larger of the width and the height of the points
+    static double
+    size (const Point& a, const Point& b, const Point& c) {
+        const BoundingBox box = geometry::bounding_box (a, b, c);
+        return std::max (box.upper.x - box.lower.x, box.upper.y - box.lower.y);
+    }
+
+    void
+    draw_vertex (const Point& p) {
+        if (_count_drawn > 0) _out += " -- \n";
+        point (p);
+        _last_drawn = p;
+        _count_drawn++;
+        _pending.reset();
+    }
+
+    void
+    point (const Point& p) {
+        _out += '(';
+        append_number (_out, p.x, _precision);
+        _out += ", ";
+        append_number (_out, p.y, _precision);
+        _out += ')';
+    }
+
+    std::string&         _out;
+    const int            _precision;
+    const double         _resolution;  // In the coordinates of the points
+    std::size_t          _count_drawn = 0;
+    Point                _last_drawn;
+    std::optional<Point> _pending;  // Vertex skipped last
+};
+
+//// Binary polygon files
+
+constexpr std::string_view binary_magic{"TRIPOLY\0", 8};
+constexpr std::uint32_t    binary_version     = 1;
+constexpr std::size_t      binary_header_size = 24;
+
+// The points are read and written in place as pairs of doubles.
+static_assert (sizeof (Point) == 2 * sizeof (double));
+
+//// Mesh files
+
+constexpr std::string_view mesh_magic{"TRIMESH\0", 8};
+constexpr std::uint32_t    mesh_version = 1;
+
+// Number of triangles converted at once before writing them
+constexpr std::size_t mesh_chunk_size = 4096;
+
+// Write the vertex indices of the triangles as Index, converted in chunks.
+// If `list`, each triangle is preceded by the number of its vertices (uint8),
+// as a list of PLY.
+template <typename Index>
+void
+write_indices (std::ostream& os, const Triangles& triangles, const bool list) {
+    // The triangles are written in place if they are in the same form.
+    if constexpr (sizeof (Index) == sizeof (std::size_t) && little_endian) {
+        if (!list) {
+            os.write (
+                reinterpret_cast<const char*> (triangles.data()),
+                static_cast<std::streamsize> (triangles.size() * sizeof (TriangleSpec))
+            );
+            return;
+        }
+    }
+
+    const std::size_t record_size = 3 * sizeof (Index) + (list ? 1 : 0);
+    std::vector<char> chunk (mesh_chunk_size * record_size);
+    for (std::size_t first = 0; first < triangles.size(); first += mesh_chunk_size) {
+        const std::size_t last = std::min (first + mesh_chunk_size, triangles.size());
+
+        char* out = chunk.data();
+        for (std::size_t t = first; t < last; ++t) {
+            if (list) *out++ = 3;
+            for (const std::size_t idx : triangles[t]) {
+                const Index index = swap_little_endian (static_cast<Index> (idx));
+                std::memcpy (out, &index, sizeof (Index));
+                out += sizeof (Index);
+            }
+        }
+        os.write (chunk.data(), out - chunk.data());
+    }
+}
+
+void
+write_indices (
+    std::ostream&     os,
+    const Triangles&  triangles,
+    const std::size_t index_size,
+    const bool        list
+) {
+    switch (index_size) {
+    case 2: write_indices<std::uint16_t> (os, triangles, list); break;
+    case 4: write_indices<std::uint32_t> (os, triangles, list); break;
+    default: write_indices<std::uint64_t> (os, triangles, list); break;
+    }
+}
+
+// Write the coordinates of the points as pairs of doubles, or as triples with
+// z = 0 if `with_z`.
+void
+write_coordinates (std::ostream& os, const std::span<const Point> points, const bool with_z) {
+    if (little_endian && !with_z) {
+        os.write (
+            reinterpret_cast<const char*> (points.data()),
+            static_cast<std::streamsize> (points.size() * sizeof (Point))
+        );
+        return;
+    }
+
+    const std::size_t   count = with_z ? 3 : 2;
+    std::vector<double> chunk;
+    chunk.reserve (mesh_chunk_size * count);
+    for (std::size_t first = 0; first < points.size(); first += mesh_chunk_size) {
+        const std::size_t last = std::min (first + mesh_chunk_size, points.size());
+
+        chunk.clear();
+        for (std::size_t i = first; i < last; ++i) {
+            chunk.push_back (swap_little_endian (points[i].x));
+            chunk.push_back (swap_little_endian (points[i].y));
+            if (with_z) chunk.push_back (0.);
+        }
+        os.write (
+            reinterpret_cast<const char*> (chunk.data()),
+            static_cast<std::streamsize> (chunk.size() * sizeof (double))
+        );
+    }
+}
+
+}  // namespace
+
+//// class CsvPolygonReader
+
+CsvPolygonReader::CsvPolygonReader (std::istream& in, const std::size_t block_size)
+    : _in{in}
+    , _block_size{std::max<std::size_t> (1, block_size)} {}
+
+// Next polygon, or std::nullopt at the end of the stream
+std::optional<Points>
+CsvPolygonReader::next () {
+    // Text of the polygon from `first`, where std::string::npos means that no
+    // line of the polygon has been found yet.
+    std::size_t first = std::string::npos;
+    std::size_t line  = _position;
+
+    while (true) {
+        const std::size_t eol = _buffer.find ('\n', line);
+
+        if (eol == std::string::npos) {
+            // Drop the text already parsed before reading more.
+            const std::size_t keep = std::min (first, line);
+            _buffer.erase (0, keep);
+            line -= keep;
+            if (first != std::string::npos) first -= keep;
+            _position = 0;
+
+            if (read_block()) continue;
+
+            // The last line may not end with a newline.
+            if (first == std::string::npos && line < _buffer.size() &&
+                !std::all_of (_buffer.cbegin() + line, _buffer.cend(), is_blank))
+                first = line;
+            _position = _buffer.size();
+
+            if (first == std::string::npos) return std::nullopt;
+            return parse_csv_points (std::string_view{_buffer}.substr (first));
+        }
+
+        const bool blank = std::all_of (_buffer.cbegin() + line, _buffer.cbegin() + eol, is_blank);
+        if (blank && first != std::string::npos) {
+            _position = eol + 1;
+            return parse_csv_points (std::string_view{_buffer}.substr (first, line - first));
+        }
+        if (!blank && first == std::string::npos) first = line;
+
+        line = eol + 1;
+    }
+}
+
+// Append a block of the stream to the buffer. Returns false at the end.
+bool
+CsvPolygonReader::read_block () {
+    const std::size_t size = _buffer.size();
+    _buffer.resize (size + _block_size);
+    _in.read (_buffer.data() + size, static_cast<std::streamsize> (_block_size));
+    _buffer.resize (size + static_cast<std::size_t> (_in.gcount()));
+    return _in.gcount() > 0;
+}
+
+//// class MappedFile
+
+#ifdef TRIANGULATE_HAS_MMAP
+MappedFile::MappedFile (const std::string& filename) {
+    const int fd = ::open (filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error ("Failed to open file: " + filename);
+
+    struct stat status;
+    if (::fstat (fd, &status) != 0) {
+        ::close (fd);
+        throw std::runtime_error ("Failed to open file: " + filename);
+    }
+
+    _size = static_cast<std::size_t> (status.st_size);
+    if (_size > 0) {
+        _mapping = ::mmap (nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (_mapping == MAP_FAILED) {
+            _mapping = nullptr;
+            ::close (fd);
+            throw std::runtime_error ("Failed to map file: " + filename);
+        }
+        ::madvise (_mapping, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char*> (_mapping);
+    }
+    ::close (fd);
+}
+
+MappedFile::~MappedFile () {
+    if (_mapping != nullptr) ::munmap (_mapping, _size);
+}
+#else
+MappedFile::MappedFile (const std::string& filename) {
+    std::ifstream file (filename, std::ios::binary | std::ios::ate);
+
+    if (!file.is_open()) {
+        throw std::runtime_error ("Failed to open file: " + filename);
+    }
+
+    _buffer.resize (static_cast<std::size_t> (file.tellg()));
+    file.seekg (0);
+    file.read (_buffer.data(), static_cast<std::streamsize> (_buffer.size()));
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+}
+
+MappedFile::~MappedFile () = default;
+#endif
+
+MappedFile::MappedFile (MappedFile&& other) noexcept
+    : _data{other._data}
+    , _size{other._size}
+    , _mapping{other._mapping}
+    , _buffer{std::move (other._buffer)} {
+    // A short buffer moves its characters along with it.
+    if (_mapping == nullptr) _data = _buffer.data();
+
+    other._data    = nullptr;
+    other._size    = 0;
+    other._mapping = nullptr;
+}
+
 // Read CSV file into a vector.
 std::vector<Point>
 read_csv_points (const std::string& filename) {
+    const MappedFile file (filename);
+    return parse_csv_points (file.view());
+}
+
+// Parse the points in CSV text, one point per line in "x, y" or "x,y" form.
+std::vector<Point>
+parse_csv_points (const std::string_view text) {
     std::vector<Point> points;
-    std::ifstream      file (filename);
+    points.reserve (std::count (text.cbegin(), text.cend(), '\n') + 1);
+
+    const char* const end  = text.data() + text.size();
+    std::size_t       line = 0;
+    for (const char* first = text.data(); first < end;) {
+        line++;
+
+        const char* last = static_cast<const char*> (std::memchr (first, '\n', end - first));
+        if (last == nullptr) last = end;
+
+        const char* comma = std::find (first, last, ',');
+        if (comma != last) {
+            const char* next_comma = std::find (comma + 1, last, ',');
+
+            Point p;
+            if (!parse_number (first, comma, p.x) || !parse_number (comma + 1, next_comma, p.y)) {
+                throw std::invalid_argument ("Invalid point at line " + std::to_string (line));
+            }
+            points.push_back (p);
+        }
+
+        first = last + 1;
+    }
+
+    return points;
+}
+
+//// Mesh files
+
+// Bytes of a vertex index in a mesh file of `count_vertices` vertices
+std::size_t
+mesh_index_size (const std::size_t count_vertices) {
+    if (count_vertices <= std::numeric_limits<std::uint16_t>::max() + std::size_t{1}) return 2;
+    if (count_vertices <= std::numeric_limits<std::uint32_t>::max() + std::uint64_t{1}) return 4;
+    return 8;
+}
+
+// Write a raw binary mesh file.
+void
+write_mesh_binary (
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles
+) {
+    std::ofstream file (filename, std::ios::binary);
 
     if (!file.is_open()) {
         throw std::runtime_error ("Failed to open file: " + filename);
     }
 
-    std::string line;
-    while (std::getline (file, line)) {
-        if (line.empty()) continue;
+    const std::size_t index_size = mesh_index_size (points.size());
+
+    file.write (mesh_magic.data(), mesh_magic.size());
+    write_little_endian<std::uint32_t> (file, mesh_version);
+    write_little_endian<std::uint32_t> (file, static_cast<std::uint32_t> (index_size));
+    write_little_endian<std::uint64_t> (file, points.size());
+    write_little_endian<std::uint64_t> (file, triangles.size());
+
+    write_coordinates (file, points, false);
+    write_indices (file, triangles, index_size, false);
 
-        std::istringstream ss (line);
-        std::string        x_str, y_str;
+    if (!file) throw std::runtime_error ("Failed to write file: " + filename);
+}
 
-        if (!std::getline (ss, x_str, ',')) continue;
-        if (!std::getline (ss, y_str, ',')) continue;
+// Write a binary PLY file.
+void
+write_mesh_ply (
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles
+) {
+    const std::size_t index_size = mesh_index_size (points.size());
+    if (index_size > 4) throw std::length_error ("Too many vertices for a PLY file");
 
-        Point p;
-        p.x = std::stod (x_str);
-        p.y = std::stod (y_str);
-        points.push_back (p);
+    std::ofstream file (filename, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error ("Failed to open file: " + filename);
     }
 
-    return points;
+    file << "ply\n"
+         << "format binary_little_endian 1.0\n"
+         << "element vertex " << points.size() << "\n"
+         << "property double x\n"
+         << "property double y\n"
+         << "property double z\n"
+         << "element face " << triangles.size() << "\n"
+         << "property list uchar " << (index_size == 2 ? "ushort" : "uint") << " vertex_indices\n"
+         << "end_header\n";
+
+    write_coordinates (file, points, true);
+    write_indices (file, triangles, index_size, true);
+
+    if (!file) throw std::runtime_error ("Failed to write file: " + filename);
+}
+
+// Write a Wavefront OBJ file.
+void
+write_mesh_obj (
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles
+) {
+    std::ofstream file (filename);
+
+    if (!file.is_open()) {
+        throw std::runtime_error ("Failed to open file: " + filename);
+    }
+
+    // The buffer is written out whenever it grows large.
+    constexpr std::size_t flush_size = 1 << 20;
+
+    std::string out;
+    for (const auto& p : points) {
+        out += "v ";
+        append_number (out, p.x);
+        out += ' ';
+        append_number (out, p.y);
+        out += " 0\n";
+        if (out.size() >= flush_size) {
+            file << out;
+            out.clear();
+        }
+    }
+
+    // The indices of OBJ start from 1.
+    for (const auto& tri : triangles) {
+        out += 'f';
+        for (const std::size_t idx : tri) {
+            char buffer[24];
+            out += ' ';
+            out.append (buffer, std::to_chars (buffer, buffer + sizeof (buffer), idx + 1).ptr);
+        }
+        out += '\n';
+        if (out.size() >= flush_size) {
+            file << out;
+            out.clear();
+        }
+    }
+    file << out;
+
+    if (!file) throw std::runtime_error ("Failed to write file: " + filename);
 }
 
 // Write points to CSV file.
+//
+// The coordinates are written in the shortest form which reads back to the
+// same values.
 void
 write_points_csv_file (
     const std::vector<Point>& points,
@@ -54,55 +579,203 @@ write_points_csv_file (
         throw std::runtime_error ("Failed to open file: " + filename);
     }
 
+    std::string text;
+    const auto  append_point = [&text] (const Point& p) {
+        append_number (text, p.x);
+        text += ", ";
+        append_number (text, p.y);
+        text += '\n';
+    };
+
     for (const auto& p : points) {
-        file << p.x << ", " << p.y << "\n";
+        append_point (p);
     }
 
-    if (cyclic) file << points.front().x << ", " << points.front().y << "\n";
+    if (cyclic) append_point (points.front());
+
+    file << text;
+}
+
+// Write polygons into a binary polygon file.
+void
+write_polygons_binary (const std::span<const Points> polygons, const std::string& filename) {
+    std::ofstream file (filename, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error ("Failed to open file: " + filename);
+    }
+
+    file.write (binary_magic.data(), binary_magic.size());
+    write_little_endian<std::uint32_t> (file, binary_version);
+    write_little_endian<std::uint32_t> (file, 0);
+    write_little_endian<std::uint64_t> (file, polygons.size());
+
+    std::uint64_t offset = 0;
+    write_little_endian (file, offset);
+    for (const Points& points : polygons) {
+        offset += points.size();
+        write_little_endian (file, offset);
+    }
+
+    for (const Points& points : polygons) {
+        if constexpr (little_endian) {
+            file.write (
+                reinterpret_cast<const char*> (points.data()),
+                static_cast<std::streamsize> (points.size() * sizeof (Point))
+            );
+        } else {
+            for (const Point& p : points) {
+                write_little_endian (file, p.x);
+                write_little_endian (file, p.y);
+            }
+        }
+    }
+
+    if (!file) throw std::runtime_error ("Failed to write file: " + filename);
+}
+
+//// class PolygonFile
+
+PolygonFile::PolygonFile (const std::string& filename)
+    : _file{filename} {
+    const std::string_view data    = _file.view();
+    const auto             invalid = [&filename] () {
+        return std::runtime_error ("Invalid polygon file: " + filename);
+    };
+
+    if (data.size() < binary_header_size || !data.starts_with (binary_magic) ||
+        read_little_endian<std::uint32_t> (data.data() + 8) != binary_version)
+        throw invalid();
+
+    // The offset table must fit in the file.
+    const std::uint64_t count_polygons = read_little_endian<std::uint64_t> (data.data() + 16);
+    if (count_polygons >= (data.size() - binary_header_size) / sizeof (std::uint64_t))
+        throw invalid();
+
+    _count_polygons = static_cast<std::size_t> (count_polygons);
+    _offsets        = data.data() + binary_header_size;
+
+    // The offsets must increase from 0, and the last one is the number of
+    // vertices, whose coordinates must fit in the file.
+    if (offset (0) != 0) throw invalid();
+    for (std::size_t i = 0; i < _count_polygons; ++i) {
+        if (offset (i + 1) < offset (i)) throw invalid();
+    }
+
+    const std::size_t coordinates_begin =
+        binary_header_size + sizeof (std::uint64_t) * (_count_polygons + 1);
+    const std::size_t count_vertices = offset (_count_polygons);
+    if (count_vertices > (data.size() - coordinates_begin) / sizeof (Point)) throw invalid();
+
+    const char* coordinates = data.data() + coordinates_begin;
+    if constexpr (little_endian) {
+        _coordinates = reinterpret_cast<const Point*> (coordinates);
+    } else {
+        _swapped.resize (count_vertices);
+        for (std::size_t k = 0; k < count_vertices; ++k) {
+            _swapped[k].x = read_little_endian<double> (coordinates + sizeof (Point) * k);
+            _swapped[k].y = read_little_endian<double> (coordinates + sizeof (Point) * k + 8);
+        }
+        _coordinates = _swapped.data();
+    }
+}
+
+// Points of the i-th polygon, valid while the file is open
+std::span<const Point>
+PolygonFile::points (const std::size_t i) const {
+    if (i >= _count_polygons) throw std::out_of_range ("Polygon index out of range");
+
+    const std::size_t first = offset (i);
+    return {_coordinates + first, offset (i + 1) - first};
+}
+
+// Offset of the first vertex of the i-th polygon
+std::size_t
+PolygonFile::offset (const std::size_t i) const {
+    return static_cast<std::size_t> (
+        read_little_endian<std::uint64_t> (_offsets + sizeof (std::uint64_t) * i)
+    );
+}
+
+// Convert CSV files, one polygon each, into a binary polygon file.
+void
+convert_csv_to_binary (
+    const std::vector<std::string>& csv_filenames,
+    const std::string&              filename
+) {
+    std::vector<Points> polygons;
+    polygons.reserve (csv_filenames.size());
+    for (const auto& csv_filename : csv_filenames) {
+        polygons.push_back (read_csv_points (csv_filename));
+    }
+
+    write_polygons_binary (polygons, filename);
+}
+
+// Convert the i-th polygon of a binary polygon file into a CSV file.
+void
+convert_binary_to_csv (
+    const std::string& filename,
+    const std::size_t  i,
+    const std::string& csv_filename
+) {
+    const PolygonFile            file (filename);
+    const std::span<const Point> points = file.points (i);
+
+    write_points_csv_file (Points (points.begin(), points.end()), csv_filename);
 }
 
 // Write TeX with TikZ routine to draw polygon and triangles.
 std::string
 string_tikz_polygon (
-    const Points&            points,
-    const std::vector<bool>& clipped,
-    const Triangles&         triangles,
-    const double             scale
+    const std::span<const Point> points,
+    const std::vector<bool>&     clipped,
+    const Triangles&             triangles,
+    const double                 scale,
+    const TikzOptions&           options
+) {
+    std::string out;
+    append_tikz_polygon (out, points, clipped, triangles, scale, options);
+    return out;
+}
+
+// Same as string_tikz_polygon, but append to `out`.
+void
+append_tikz_polygon (
+    std::string&                 out,
+    const std::span<const Point> points,
+    const std::vector<bool>&     clipped,
+    const Triangles&             triangles,
+    const double                 scale,
+    const TikzOptions&           options
 ) {
-    std::stringstream strm;
+    TikzWriter writer (out, scale, options);
 
-    // Create temporary points
-    Points points_enabled;
-    points_enabled.reserve (std::count (clipped.cbegin(), clipped.cend(), true));
+    writer.begin_picture (scale);
 
+    // The outline through the vertices remaining, back to the first of them
+    const auto first = std::find (clipped.cbegin(), clipped.cend(), false);
+    writer.begin_outline();
     for (std::size_t i = 0; i < clipped.size(); ++i) {
-        if (clipped[i] == false) points_enabled.push_back (points[i]);
-    }
-    points_enabled.push_back (points_enabled.front());
-
-    strm << "\\tikzpicture[scale=" << scale << "]\n";
-    strm << "\\draw[thick]\n";
-    for (std::size_t i = 0; i < points_enabled.size() - 1; ++i) {
-        strm << points_enabled[i] << " -- \n";
+        if (clipped[i] == false) writer.vertex (points[i]);
     }
-    strm << points_enabled.back() << ";\n";
+    if (first != clipped.cend()) writer.vertex (points[first - clipped.cbegin()]);
+    writer.end_outline();
 
     for (const auto& tri : triangles) {
-        strm << "\\draw[ultra thin]" << points[tri[0]] << " -- " << points[tri[1]] << " -- "
-             << points[tri[2]] << " -- cycle;\n";
+        writer.triangle (points[tri[0]], points[tri[1]], points[tri[2]]);
     }
-    strm << "\\endtikzpicture\n";
-
-    return strm.str();
+    writer.end_picture();
 }
 
 void
 write_tex_tikz (
-    const std::string& filename,
-    const Points&      points,
-    const Triangles&   triangles,
-    const double       area,
-    const double       scale
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles,
+    const double                 area,
+    const double                 scale,
+    const TikzOptions&           options
 ) {
     std::ofstream file (filename);
 
@@ -110,48 +783,63 @@ write_tex_tikz (
         throw std::runtime_error ("Failed to open file: " + filename);
     }
 
-    file << "\\input tikz.tex\n"
-         << "\\baselineskip=12pt\n"
-         << "\\hsize=6.3truein\n"
-         << "\\vsize=8.7truein\n";
+    // The outline is drawn on both pages, so it is formatted once.
+    std::string outline;
+    {
+        TikzWriter writer (outline, scale, options);
+        writer.begin_outline();
+        for (const auto& p : points) {
+            writer.vertex (p);
+        }
+        writer.end_outline();
+    }
 
-    file << "The original polygon:\n"
-         << "\\vskip12pt\n";
+    std::string out;
+    TikzWriter  writer (out, scale, options);
+
+    out += "\\input tikz.tex\n"
+           "\\baselineskip=12pt\n"
+           "\\hsize=6.3truein\n"
+           "\\vsize=8.7truein\n";
+
+    out += "The original polygon:\n"
+           "\\vskip12pt\n";
 
     // Original polygon
-    file << "\\tikzpicture[scale=" << scale << "]\n";
-    file << "\\draw[thick]\n";
-    for (std::size_t i = 0; i < points.size() - 1; ++i) {
-        file << points[i] << " -- \n";
-    }
-    file << points.back() << ";\n";
+    writer.begin_picture (scale);
+    out += outline;
+    writer.end_picture();
 
-    file << "\\endtikzpicture\n"
-         << "\\vfill\\eject\n";
+    out += "\\vfill\\eject\n";
 
-    file << "Triangulation:\n"
-         << "\\vskip12pt\n";
+    out += "Triangulation:\n"
+           "\\vskip12pt\n";
 
     // Triangulation
-    file << "\\tikzpicture[scale=" << scale << "]\n";
+    writer.begin_picture (scale);
     // Outer polygon
-    file << "\\draw[thick]\n";
-    for (std::size_t i = 0; i < points.size() - 1; ++i) {
-        file << points[i] << " -- \n";
-    }
-    file << points.back() << ";\n";
+    out += outline;
 
+    // The buffer is written out whenever it grows large.
+    constexpr std::size_t flush_size = 1 << 20;
     for (const auto& tri : triangles) {
-        file << "\\draw[ultra thin]" << points[tri[0]] << " -- " << points[tri[1]] << " -- "
-             << points[tri[2]] << " -- cycle;\n";
+        writer.triangle (points[tri[0]], points[tri[1]], points[tri[2]]);
+        if (out.size() >= flush_size) {
+            file << out;
+            out.clear();
+        }
     }
-    file << "\\endtikzpicture\n";
+    writer.end_picture();
+
+    out += "\\vskip24pt\n"
+           "Area = ";
+    append_number (out, area, 6);
+    out += "\n";
 
-    file << "\\vskip24pt\n"
-         << "Area = " << area << "\n";
+    out += "\\vfill\\eject\n"
+           "\\bye\n";
 
-    file << "\\vfill\\eject\n"
-         << "\\bye\n";
+    file << out;
 }
 
 // Convert a Point to stream
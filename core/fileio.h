@@ -6,7 +6,12 @@
 #ifndef __FILE_IO_H__
 #define __FILE_IO_H__
 
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/primitive.h"
@@ -16,9 +21,186 @@
 namespace fileio {
 
 // Read CSV file into a vector.
+//
+// The file is memory-mapped where the platform supports it, and read in one
+// block otherwise. See parse_csv_points for the format.
 std::vector<Point>
 read_csv_points (const std::string& filename);
 
+// Parse the points in CSV text, one point per line in "x, y" or "x,y" form.
+// Empty lines and lines without a comma are skipped, and fields after the
+// second one are ignored. Throws std::invalid_argument if a coordinate is not
+// a number.
+std::vector<Point>
+parse_csv_points (const std::string_view text);
+
+//// class CsvPolygonReader
+
+// Reads polygons one after another from CSV text in the format of
+// parse_csv_points, where the polygons are separated by empty lines. The
+// stream is read in blocks, and only the text of the current polygon is kept.
+class CsvPolygonReader {
+  public:
+    explicit CsvPolygonReader (std::istream& in, const std::size_t block_size = 1 << 20);
+
+    // Next polygon, or std::nullopt at the end of the stream
+    std::optional<Points>
+    next ();
+
+  private:
+    // Append a block of the stream to the buffer. Returns false at the end.
+    bool
+    read_block ();
+
+    std::istream&     _in;
+    const std::size_t _block_size;
+    std::string       _buffer;
+    std::size_t       _position = 0;  // Beginning of the text not parsed yet
+};
+
+//// class MappedFile
+
+// Read-only contents of a file. The file is memory-mapped where the platform
+// supports it, and read into a buffer otherwise.
+class MappedFile {
+  public:
+    explicit MappedFile (const std::string& filename);
+    ~MappedFile ();
+
+    MappedFile (MappedFile&& other) noexcept;
+    MappedFile (const MappedFile&)            = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+    MappedFile& operator= (MappedFile&&)      = delete;
+
+    std::string_view
+    view () const {
+        return {_data, _size};
+    }
+
+  private:
+    const char* _data    = nullptr;
+    std::size_t _size    = 0;
+    void*       _mapping = nullptr;  // If memory-mapped
+    std::string _buffer;             // Otherwise
+};
+
+//// Binary polygon files
+//
+// A binary polygon file holds any number of polygons, all in little-endian:
+//
+//   offset  size         contents
+//   0       8            magic "TRIPOLY\0"
+//   8       4            version (uint32, 1)
+//   12      4            reserved (0)
+//   16      8            number of polygons n (uint64)
+//   24      8 * (n + 1)  vertex offsets (uint64): polygon i consists of the
+//                        vertices offsets[i] to offsets[i + 1] - 1
+//   ...     16 * count   vertex coordinates (double x, double y), where
+//                        count = offsets[n]
+//
+// The coordinates start at a multiple of 8 bytes, so they are read in place as
+// an array of Point.
+
+// Write polygons into a binary polygon file.
+void
+write_polygons_binary (const std::span<const Points> polygons, const std::string& filename);
+
+//// class PolygonFile
+
+// Binary polygon file mapped into memory. Opening a file reads only the header
+// and the offset table, and the points of each polygon are accessed in place
+// without parsing or copying.
+class PolygonFile {
+  public:
+    // Throws std::runtime_error if the file cannot be opened or is not a
+    // valid binary polygon file.
+    explicit PolygonFile (const std::string& filename);
+
+    // Number of polygons
+    std::size_t
+    size () const {
+        return _count_polygons;
+    }
+
+    // Points of the i-th polygon, valid while the file is open
+    std::span<const Point>
+    points (const std::size_t i) const;
+
+  private:
+    // Offset of the first vertex of the i-th polygon
+    std::size_t
+    offset (const std::size_t i) const;
+
+    MappedFile         _file;
+    std::size_t        _count_polygons = 0;
+    const char*        _offsets        = nullptr;  // Offset table in the file
+    const Point*       _coordinates    = nullptr;
+    std::vector<Point> _swapped;  // Coordinates on big-endian platforms
+};
+
+// Convert CSV files, one polygon each, into a binary polygon file.
+void
+convert_csv_to_binary (
+    const std::vector<std::string>& csv_filenames,
+    const std::string&              filename
+);
+
+// Convert the i-th polygon of a binary polygon file into a CSV file.
+void
+convert_binary_to_csv (
+    const std::string& filename,
+    const std::size_t  i,
+    const std::string& csv_filename
+);
+
+//// Mesh files
+//
+// The vertices and the triangles of a triangulation, for the programs which
+// take a triangle mesh, e.g., renderers and FEM solvers. The vertex indices
+// are written in the narrowest of 16, 32 and 64 bits which can hold all of
+// them.
+//
+// A raw binary mesh file is, all in little-endian:
+//
+//   offset  size        contents
+//   0       8           magic "TRIMESH\0"
+//   8       4           version (uint32, 1)
+//   12      4           bytes of a vertex index w (uint32, 2, 4 or 8)
+//   16      8           number of vertices n (uint64)
+//   24      8           number of triangles m (uint64)
+//   32      16 * n      vertex coordinates (double x, double y)
+//   ...     3 * w * m   vertex indices of the triangles (unsigned)
+
+// Bytes of a vertex index in a mesh file of `count_vertices` vertices
+std::size_t
+mesh_index_size (const std::size_t count_vertices);
+
+// Write a raw binary mesh file.
+void
+write_mesh_binary (
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles
+);
+
+// Write a binary PLY file, whose vertices have the properties x, y and z = 0
+// (double), and faces the list vertex_indices (ushort or uint). Throws
+// std::length_error if an index does not fit in 32 bits.
+void
+write_mesh_ply (
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles
+);
+
+// Write a Wavefront OBJ file, whose vertices have z = 0.
+void
+write_mesh_obj (
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles
+);
+
 // Write CSV file
 void
 write_points_csv_file (
@@ -27,21 +209,52 @@ write_points_csv_file (
     const bool         cyclic = false
 );
 
+//// Struct: TikzOptions
+
+struct TikzOptions {
+    // Significant digits of the coordinates
+    int precision = 6;
+
+    // Level of detail: if positive, the features smaller than this in the
+    // picture, i.e., after scaling, are dropped. A vertex of the outline is
+    // dropped if it is closer than this to the last vertex drawn, and a
+    // triangle if both of its width and height are smaller than this. The
+    // unit is that of TikZ (cm), e.g., 0.01 for 0.1 mm.
+    double resolution = 0.;
+};
+
 // Write TeX with TikZ routine to draw polygon and triangles.
+//
+// The vertices marked in `clipped` are not drawn in the outline.
 std::string
 string_tikz_polygon (
-    const Points&            points,
-    const std::vector<bool>& clipped,
-    const Triangles&         triangles,
-    const double             scale
+    const std::span<const Point> points,
+    const std::vector<bool>&     clipped,
+    const Triangles&             triangles,
+    const double                 scale,
+    const TikzOptions&           options = {}
+);
+
+// Same as string_tikz_polygon, but append to `out`, so that a buffer can be
+// reused for many pictures.
+void
+append_tikz_polygon (
+    std::string&                 out,
+    const std::span<const Point> points,
+    const std::vector<bool>&     clipped,
+    const Triangles&             triangles,
+    const double                 scale,
+    const TikzOptions&           options = {}
 );
+
 void
 write_tex_tikz (
-    const std::string& filename,
-    const Points&      points,
-    const Triangles&   triangles,
-    const double       area,
-    const double       scale
+    const std::string&           filename,
+    const std::span<const Point> points,
+    const Triangles&             triangles,
+    const double                 area,
+    const double                 scale,
+    const TikzOptions&           options = {}
 );
 
 // Convert a Point to stream
@@ -1,9 +1,14 @@
 #include "core/geometry.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <numbers>
+#include <span>
+#include <type_traits>
 
 #include "core/numeric.h"
+#include "core/predicates.h"
 
 //// NAMESPACE: geometry
 namespace geometry {
@@ -51,6 +56,10 @@ constrain_rotational_angle (const double q) {
 //
 // The line segments have intersection iif 0 < a < 1 and 0 < b < 1, excluding
 // the intersection at the ends.
+//
+// The bounds of a and b are decided by the signs of the orientations
+// predicates::orient2d of the end points, without dividing by the
+// determinant, so the result is exact for any input.
 bool
 does_intersect (
     const Point&   p,
@@ -60,53 +69,203 @@ does_intersect (
     const LineType line_type,
     const bool     ignore_endpoints
 ) {
-    const double A_11 = q.x - p.x;
-    const double A_12 = r.x - s.x;
-    const double A_21 = q.y - p.y;
-    const double A_22 = r.y - s.y;
-
-    const double det = A_11 * A_22 - A_12 * A_21;
-    if (numeric::close_enough (det, 0.0)) return false;
-
-    const double b_1 = r.x - p.x;
-    const double b_2 = r.y - p.y;
-
-    const double a = (A_22 * b_1 - A_12 * b_2) / det;
-    const double b = (-A_21 * b_1 + A_11 * b_2) / det;
-
-    if (ignore_endpoints) {
-        switch (line_type) {
-        case LineType::segment: return (0. < a && a < 1. && 0. < b && b < 1.); break;
-        case LineType::ray: return (0. < a && 0. < b && b < 1.); break;
-        case LineType::infinite_line: return (0. < b && b < 1.); break;
-        }
-    } else {
-        switch (line_type) {
-        case LineType::segment: return (0. <= a && a <= 1. && 0. <= b && b <= 1.); break;
-        case LineType::ray: return (0. <= a && 0. <= b && b <= 1.); break;
-        case LineType::infinite_line: return (0. <= b && b <= 1.); break;
-        }
+    // b = o_r / (o_r - o_s), where o_r and o_s are the orientations of r and
+    // s w.r.t. the line from p to q
+    const int o_r = numeric::sign (predicates::orient2d (p, q, r));
+    const int o_s = numeric::sign (predicates::orient2d (p, q, s));
+
+    // Parallel or collinear
+    if (o_r == o_s) return false;
+
+    if (ignore_endpoints ? o_r * o_s >= 0 : o_r * o_s > 0) return false;
+
+    // Sign of the determinant o_r - o_s
+    const int det = o_r != 0 ? o_r : -o_s;
+
+    // a = -o_p / det and 1 - a = o_q / det, where o_p and o_q are the
+    // orientations of p and q w.r.t. the line from r to s
+    const auto a_above_lower = [&] () {
+        const int o_p = numeric::sign (predicates::orient2d (r, s, p));
+        return ignore_endpoints ? o_p == -det : o_p != det;
+    };
+    const auto a_below_upper = [&] () {
+        const int o_q = numeric::sign (predicates::orient2d (r, s, q));
+        return ignore_endpoints ? o_q == det : o_q != -det;
+    };
+
+    switch (line_type) {
+    case LineType::segment: return a_above_lower() && a_below_upper(); break;
+    case LineType::ray: return a_above_lower(); break;
+    case LineType::infinite_line: return true; break;
     }
 
     return false;
 }
 
+// Mid-point between two points
+Point
+midpoint (const Point& a, const Point& b) {
+    return Point{(a.x + b.x) / 2., (a.y + b.y) / 2.};
+}
+
+//// Functions templated on the coordinate type
+
 // Calculate the area of a triangle
+template <typename T>
 double
-area (const Point& a, const Point& b, const Point& c) {
-    const double px = b.x - a.x;
-    const double py = b.y - a.y;
+area (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c) {
+    const Point o = to_point (a);
+
+    const double px = static_cast<double> (b.x) - o.x;
+    const double py = static_cast<double> (b.y) - o.y;
 
-    const double qx = c.x - a.x;
-    const double qy = c.y - a.y;
+    const double qx = static_cast<double> (c.x) - o.x;
+    const double qy = static_cast<double> (c.y) - o.y;
 
     return .5 * std::abs (px * qy - py * qx);
 }
 
-// Mid-point between two points
-Point
-midpoint (const Point& a, const Point& b) {
-    return Point{(a.x + b.x) / 2., (a.y + b.y) / 2.};
+// Orientation of three points, i.e., twice the signed area of the triangle
+// (a, b, c). Positive if the points wind counter-clockwise, negative if
+// clockwise, and zero if they are collinear.
+//
+// Fixed-point coordinates are computed exactly in integers, and the conversion
+// to double keeps the sign. Floating-point coordinates go through
+// predicates::orient2d, as float converts to double exactly.
+template <typename T>
+double
+orientation (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c) {
+    if constexpr (std::is_integral_v<T>) {
+        const T det = (a.x - c.x) * (b.y - c.y) - (a.y - c.y) * (b.x - c.x);
+        return static_cast<double> (det);
+    } else {
+        return predicates::orient2d (to_point (a), to_point (b), to_point (c));
+    }
+}
+
+// Signed area of a polygon (shoelace formula). Positive if the points wind
+// counter-clockwise, and negative if clockwise. The polygon is closed
+// implicitly, so the last point may or may not coincide with the first one.
+//
+// The coordinates are taken relative to the first point, which reduces the
+// cancellation error when the polygon is far from the origin.
+template <typename T>
+double
+signed_area (const std::span<const BasicPoint<T>> points) {
+    if (points.size() < 3) return 0.;
+
+    const Point o   = to_point (points.front());
+    double      sum = 0.;
+    for (std::size_t i = 1; i + 1 < points.size(); ++i) {
+        const double px = static_cast<double> (points[i].x) - o.x;
+        const double py = static_cast<double> (points[i].y) - o.y;
+        const double qx = static_cast<double> (points[i + 1].x) - o.x;
+        const double qy = static_cast<double> (points[i + 1].y) - o.y;
+        sum += px * qy - py * qx;
+    }
+    return .5 * sum;
+}
+
+// Sine of the smallest interior angle of a triangle, which measures the
+// quality of the triangle: 0 for a degenerate triangle and sqrt(3)/2 for an
+// equilateral one.
+//
+// The smallest angle faces the shortest edge, and its sine is the twice of the
+// area divided by the lengths of the other two edges.
+template <typename T>
+double
+smallest_angle_sine (
+    const BasicPoint<T>& a_t,
+    const BasicPoint<T>& b_t,
+    const BasicPoint<T>& c_t
+) {
+    const Point a = to_point (a_t);
+    const Point b = to_point (b_t);
+    const Point c = to_point (c_t);
+
+    const double ab = std::pow (b.x - a.x, 2) + std::pow (b.y - a.y, 2);
+    const double bc = std::pow (c.x - b.x, 2) + std::pow (c.y - b.y, 2);
+    const double ca = std::pow (a.x - c.x, 2) + std::pow (a.y - c.y, 2);
+
+    const double shortest = std::min ({ab, bc, ca});
+    const double product  = (shortest == ab ? bc * ca : (shortest == bc ? ab * ca : ab * bc));
+    if (product == 0.) return 0.;
+
+    return 2. * area (a, b, c) / std::sqrt (product);
+}
+
+// Determine whether a point p lies inside the triangle (a, b, c), including
+// its boundary. The triangle may wind in either direction.
+template <typename T>
+bool
+is_inside_triangle (
+    const BasicPoint<T>& a,
+    const BasicPoint<T>& b,
+    const BasicPoint<T>& c,
+    const BasicPoint<T>& p
+) {
+    const double d_1 = orientation (a, b, p);
+    const double d_2 = orientation (b, c, p);
+    if ((d_1 < 0. && d_2 > 0.) || (d_1 > 0. && d_2 < 0.)) return false;
+
+    const double d_3 = orientation (c, a, p);
+    const bool has_negative = d_1 < 0. || d_2 < 0. || d_3 < 0.;
+    const bool has_positive = d_1 > 0. || d_2 > 0. || d_3 > 0.;
+
+    return !(has_negative && has_positive);
+}
+
+// Axis-aligned bounding box of a triangle
+template <typename T>
+BoundingBox
+bounding_box (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c) {
+    return BoundingBox{
+        .lower = to_point (BasicPoint<T>{std::min ({a.x, b.x, c.x}), std::min ({a.y, b.y, c.y})}),
+        .upper = to_point (BasicPoint<T>{std::max ({a.x, b.x, c.x}), std::max ({a.y, b.y, c.y})})
+    };
+}
+
+// Axis-aligned bounding box of points
+template <typename T>
+BoundingBox
+bounding_box (const std::span<const BasicPoint<T>> points) {
+    if (points.empty()) return BoundingBox{};
+
+    BasicPoint<T> lower = points.front();
+    BasicPoint<T> upper = points.front();
+    for (const auto& p : points) {
+        lower.x = std::min (lower.x, p.x);
+        lower.y = std::min (lower.y, p.y);
+        upper.x = std::max (upper.x, p.x);
+        upper.y = std::max (upper.y, p.y);
+    }
+    return BoundingBox{.lower = to_point (lower), .upper = to_point (upper)};
+}
+
+// Instantiations for PointF, Point and PointI
+#define INSTANTIATE_GEOMETRY(P)                                                       \
+    template double      area (const P&, const P&, const P&);                         \
+    template double      orientation (const P&, const P&, const P&);                  \
+    template double      signed_area (const std::span<const P>);                      \
+    template double      smallest_angle_sine (const P&, const P&, const P&);          \
+    template bool        is_inside_triangle (const P&, const P&, const P&, const P&); \
+    template BoundingBox bounding_box (const P&, const P&, const P&);                 \
+    template BoundingBox bounding_box (const std::span<const P>);
+
+INSTANTIATE_GEOMETRY (PointF)
+INSTANTIATE_GEOMETRY (Point)
+INSTANTIATE_GEOMETRY (PointI)
+
+#undef INSTANTIATE_GEOMETRY
+
+double
+signed_area (const std::span<const Point> points) {
+    return signed_area<double> (points);
+}
+
+BoundingBox
+bounding_box (const std::span<const Point> points) {
+    return bounding_box<double> (points);
 }
 
 }  // namespace geometry
@@ -6,6 +6,9 @@
 #ifndef __GEOMETRY_H__
 #define __GEOMETRY_H__
 
+#include <cstdint>
+#include <span>
+
 #include "core/primitive.h"
 
 //// NAMESPACE: geometry
@@ -28,6 +31,10 @@ polar_coordinate (const Point& p, const Point& q);
 double
 constrain_rotational_angle (const double q);
 
+// Mid-point between two points
+Point
+midpoint (const Point& a, const Point& b);
+
 // Determine whether two line segments intersect or not.
 // First line segment is from p to q.
 // Second line segment is from r to s.
@@ -44,6 +51,10 @@ constrain_rotational_angle (const double q);
 //
 // The line segments have intersection iif 0 < a < 1 and 0 < b < 1, excluding
 // the intersection at the ends.
+//
+// The bounds of a and b are decided by the signs of the orientations
+// predicates::orient2d of the end points, without dividing by the
+// determinant, so the result is exact for any input.
 enum class LineType { segment, ray, infinite_line };
 
 bool
@@ -56,13 +67,70 @@ does_intersect (
     const bool     ignore_endpoints = true
 );
 
+//// Functions templated on the coordinate type
+//
+// These are instantiated for float, double and std::int64_t, i.e., PointF,
+// Point and PointI.
+
+// Bound of the fixed-point coordinates: the orientation of PointI is exact in
+// 64-bit integers while |x| and |y| are less than this.
+inline constexpr std::int64_t fixed_point_limit = std::int64_t{1} << 30;
+
 // Calculate the area of a triangle
+template <typename T>
 double
-area (const Point& a, const Point& b, const Point& c);
+area (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c);
 
-// Mid-point between two points
-Point
-midpoint (const Point& a, const Point& b);
+// Orientation of three points, i.e., twice the signed area of the triangle
+// (a, b, c). Positive if the points wind counter-clockwise, negative if
+// clockwise, and zero if they are collinear. The sign is exact even for
+// nearly collinear points (see predicates::orient2d).
+template <typename T>
+double
+orientation (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c);
+
+// Signed area of a polygon (shoelace formula). Positive if the points wind
+// counter-clockwise, and negative if clockwise. The polygon is closed
+// implicitly, so the last point may or may not coincide with the first one.
+template <typename T>
+double
+signed_area (const std::span<const BasicPoint<T>> points);
+
+// Same as above for points of double coordinates, to which a Points vector
+// converts without naming the span
+double
+signed_area (const std::span<const Point> points);
+
+// Sine of the smallest interior angle of a triangle, which measures the
+// quality of the triangle: 0 for a degenerate triangle and sqrt(3)/2 for an
+// equilateral one.
+template <typename T>
+double
+smallest_angle_sine (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c);
+
+// Determine whether a point p lies inside the triangle (a, b, c), including
+// its boundary. The triangle may wind in either direction.
+template <typename T>
+bool
+is_inside_triangle (
+    const BasicPoint<T>& a,
+    const BasicPoint<T>& b,
+    const BasicPoint<T>& c,
+    const BasicPoint<T>& p
+);
+
+// Axis-aligned bounding box of a triangle
+template <typename T>
+BoundingBox
+bounding_box (const BasicPoint<T>& a, const BasicPoint<T>& b, const BasicPoint<T>& c);
+
+// Axis-aligned bounding box of points
+template <typename T>
+BoundingBox
+bounding_box (const std::span<const BasicPoint<T>> points);
+
+BoundingBox
+bounding_box (const std::span<const Point> points);
 
 }  // namespace geometry
 
@@ -0,0 +1,480 @@
+#include "core/incremental.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+#include "core/geometry.h"
+#include "core/polygon.h"
+
+namespace {
+
+// Number of times a cavity grows before the whole polygon is triangulated
+// again. Each time adds only the triangles in the way, which are few.
+constexpr int max_growth = 32;
+
+// Size of the cells of the edge grid, twice the mean length of the edges
+double
+cell_size (const std::span<const Point> points) {
+    double length = 0.;
+    for (std::size_t i = 0; i + 1 < points.size(); ++i) {
+        length += geometry::distance (points[i], points[i + 1]);
+    }
+    const double mean = points.size() > 1 ? length / (points.size() - 1) : 0.;
+    return mean > 0. ? 2. * mean : 1.;
+}
+
+// Determine whether the point p lies on the line segment (a, b), including its
+// ends.
+bool
+is_on_segment (const Point& a, const Point& b, const Point& p) {
+    if (geometry::orientation (a, b, p) != 0.) return false;
+
+    return std::min (a.x, b.x) <= p.x && p.x <= std::max (a.x, b.x) &&
+           std::min (a.y, b.y) <= p.y && p.y <= std::max (a.y, b.y);
+}
+
+}  // namespace
+
+IncrementalTriangulation::IncrementalTriangulation (const std::span<const Point> points)
+    : _edges{cell_size (points), points.size()} {
+    if (points.size() < 4) throw std::invalid_argument ("A polygon needs at least 3 vertices");
+
+    const std::size_t count_vertices = points.size() - 1;
+    for (std::size_t i = 0; i < count_vertices; ++i) new_vertex (points[i]);
+
+    for (std::size_t i = 0; i < count_vertices; ++i) {
+        _prev[i] = i == 0 ? count_vertices - 1 : i - 1;
+        _next[i] = i + 1 == count_vertices ? 0 : i + 1;
+        _edges.insert (i, _points[i], _points[_next[i]]);
+    }
+
+    triangulate_all();
+}
+
+//// Edits
+
+void
+IncrementalTriangulation::move_vertex (const std::size_t v, const Point& p) {
+    check_vertex (v);
+    const std::size_t u = _prev[v];
+    const std::size_t w = _next[v];
+
+    const std::array<Point, 4> changed{_points[u], _points[v], _points[w], p};
+    const BoundingBox          box = geometry::bounding_box (changed);
+
+    _edges.remove (u, _points[u], _points[v]);
+    _edges.remove (v, _points[v], _points[w]);
+    _points[v] = p;
+    _edges.insert (u, _points[u], _points[v]);
+    _edges.insert (v, _points[v], _points[w]);
+
+    const Edge new_edges[] = {{u, v}, {v, w}};
+    update ({.new_edges = new_edges, .box = box}, _incident[v]);
+}
+
+std::size_t
+IncrementalTriangulation::insert_vertex (const std::size_t after, const Point& p) {
+    check_vertex (after);
+    const std::size_t u = after;
+    const std::size_t w = _next[u];
+
+    const std::size_t v = new_vertex (p);
+    _next[u]            = v;
+    _prev[v]            = u;
+    _next[v]            = w;
+    _prev[w]            = v;
+
+    _edges.remove (u, _points[u], _points[w]);
+    _edges.insert (u, _points[u], _points[v]);
+    _edges.insert (v, _points[v], _points[w]);
+
+    // The cavity starts from the triangle of the edge (u, w), which is split.
+    // The edge is in the triangle in either direction, and npos is the largest.
+    const std::size_t t = std::min (triangle_across (u, w), triangle_across (w, u));
+    const std::span<const std::size_t> cavity{&t, t != npos ? std::size_t{1} : 0};
+
+    const std::array<Point, 3> changed{_points[u], _points[v], _points[w]};
+    const BoundingBox          box = geometry::bounding_box (changed);
+    const Edge                 new_edges[] = {{u, v}, {v, w}};
+    update ({.inserted = v, .u = u, .w = w, .new_edges = new_edges, .box = box}, cavity);
+    return v;
+}
+
+void
+IncrementalTriangulation::remove_vertex (const std::size_t v) {
+    check_vertex (v);
+    if (_size == 3) throw std::invalid_argument ("A polygon needs at least 3 vertices");
+
+    const std::size_t u = _prev[v];
+    const std::size_t w = _next[v];
+
+    _edges.remove (u, _points[u], _points[v]);
+    _edges.remove (v, _points[v], _points[w]);
+    _edges.insert (u, _points[u], _points[w]);
+
+    _next[u] = w;
+    _prev[w] = u;
+    _prev[v] = npos;
+    _next[v] = npos;
+    _free_vertices.push_back (v);
+    --_size;
+
+    // The triangles of v are removed with the cavity.
+    const std::array<Point, 3> changed{_points[u], _points[v], _points[w]};
+    const BoundingBox          box = geometry::bounding_box (changed);
+    const Edge                 new_edges[] = {{u, w}};
+    update ({.removed = v, .new_edges = new_edges, .box = box}, _incident[v]);
+}
+
+Triangles
+IncrementalTriangulation::triangles () const {
+    Triangles triangles;
+    triangles.reserve (_triangles.size() - _free_triangles.size());
+    for (const TriangleSpec& t : _triangles) {
+        if (t[0] != npos) triangles.push_back (t);
+    }
+    return triangles;
+}
+
+//// Vertices and triangles
+
+void
+IncrementalTriangulation::check_vertex (const std::size_t v) const {
+    if (v >= _next.size() || _next[v] == npos) throw std::out_of_range ("Invalid vertex handle");
+}
+
+std::size_t
+IncrementalTriangulation::new_vertex (const Point& p) {
+    ++_size;
+    if (!_free_vertices.empty()) {
+        const std::size_t v = _free_vertices.back();
+        _free_vertices.pop_back();
+        _points[v] = p;
+        return v;
+    }
+
+    _points.push_back (p);
+    _prev.push_back (npos);
+    _next.push_back (npos);
+    _incident.emplace_back();
+    _cycle_index.push_back (npos);
+    _successor.push_back (npos);
+    return _points.size() - 1;
+}
+
+void
+IncrementalTriangulation::add_triangle (
+    const std::size_t a,
+    const std::size_t b,
+    const std::size_t c
+) {
+    const double area = geometry::area (_points[a], _points[b], _points[c]);
+
+    std::size_t t = _triangles.size();
+    if (_free_triangles.empty()) {
+        _triangles.push_back ({a, b, c});
+        _triangle_areas.push_back (area);
+    } else {
+        t = _free_triangles.back();
+        _free_triangles.pop_back();
+        _triangles[t]      = {a, b, c};
+        _triangle_areas[t] = area;
+    }
+
+    for (const std::size_t v : _triangles[t]) _incident[v].push_back (t);
+    _area += area;
+}
+
+void
+IncrementalTriangulation::remove_triangle (const std::size_t t) {
+    for (const std::size_t v : _triangles[t]) {
+        std::vector<std::size_t>& incident = _incident[v];
+        *std::ranges::find (incident, t) = incident.back();
+        incident.pop_back();
+    }
+
+    // The vertices may have moved since the triangle was added.
+    _area -= _triangle_areas[t];
+    _triangles[t] = {npos, npos, npos};
+    _free_triangles.push_back (t);
+}
+
+//// Cavity
+
+// While the cavity is not valid, it grows by the triangles in the way, up to
+// max_growth times.
+void
+IncrementalTriangulation::update (const Edit& edit, const std::span<const std::size_t> triangles) {
+    _cavity.assign (triangles.begin(), triangles.end());
+
+    bool is_done = false;
+    for (int i = 0; i <= max_growth; ++i) {
+        std::ranges::sort (_cavity);
+        _cavity.erase (std::unique (_cavity.begin(), _cavity.end()), _cavity.end());
+
+        _growth.clear();
+        const bool is_valid = trace_cycle() && edit_cycle (edit) && check_cavity (edit);
+        if (is_valid) is_done = triangulate_cavity();
+
+        for (const std::size_t v : _cycle) _cycle_index[v] = npos;
+        _cycle.clear();
+
+        if (is_valid || _growth.empty()) break;
+        _cavity.insert (_cavity.end(), _growth.begin(), _growth.end());
+    }
+
+    if (!is_done) {
+        ++_count_rebuilds;
+        triangulate_all();
+    }
+}
+
+bool
+IncrementalTriangulation::trace_cycle () {
+    // The boundary consists of the edges whose twins are not in the cavity.
+    _boundary.clear();
+    for (const std::size_t t : _cavity) {
+        const auto [a, b, c] = _triangles[t];
+        _boundary.insert (_boundary.end(), {Edge{a, b}, Edge{b, c}, Edge{c, a}});
+    }
+    std::ranges::sort (_boundary);
+
+    std::size_t count_edges = 0;
+    std::size_t start       = npos;
+    bool        is_cycle    = true;
+    for (const auto& [a, b] : _boundary) {
+        if (std::ranges::binary_search (_boundary, Edge{b, a})) continue;
+
+        // Two edges leave a, so the boundary touches itself at a. The cavity
+        // grows by the triangles around a, which then leave only the edges of
+        // the polygon at a on the boundary.
+        if (_successor[a] != npos) {
+            is_cycle = false;
+            _growth.insert (_growth.end(), _incident[a].begin(), _incident[a].end());
+        }
+
+        _successor[a] = b;
+        start         = a;
+        ++count_edges;
+    }
+
+    _cycle.clear();
+    if (is_cycle && count_edges > 0) {
+        std::size_t v = start;
+        do {
+            _cycle.push_back (v);
+            v = _successor[v];
+        } while (v != start && v != npos && _cycle.size() <= count_edges);
+
+        is_cycle = v == start && _cycle.size() == count_edges;
+    }
+
+    for (const auto& [a, b] : _boundary) _successor[a] = npos;
+
+    if (!is_cycle || count_edges == 0) {
+        _cycle.clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+IncrementalTriangulation::edit_cycle (const Edit& edit) {
+    if (edit.removed != npos) {
+        const auto it = std::ranges::find (_cycle, edit.removed);
+        if (it == _cycle.end()) return false;
+        _cycle.erase (it);
+    }
+
+    // The edge (u, w) is on the boundary, in either direction.
+    if (edit.inserted != npos) {
+        const std::size_t k = _cycle.size();
+
+        std::size_t i = 0;
+        for (; i < k; ++i) {
+            const std::size_t a = _cycle[i];
+            const std::size_t b = _cycle[i + 1 == k ? 0 : i + 1];
+            if ((a == edit.u && b == edit.w) || (a == edit.w && b == edit.u)) break;
+        }
+        if (i == k) return false;
+        _cycle.insert (_cycle.begin() + i + 1, edit.inserted);
+    }
+
+    _cycle_points.clear();
+    for (std::size_t i = 0; i < _cycle.size(); ++i) {
+        _cycle_index[_cycle[i]] = i;
+        _cycle_points.push_back (_points[_cycle[i]]);
+    }
+    _cycle_points.push_back (_cycle_points.front());
+    return true;
+}
+
+// The triangles outside of the cavity are kept as they are, so the cavity
+// should be a simple polygon, winding counter-clockwise as its triangles did,
+// and should not overlap the other triangles.
+//
+// The edges of the cycle which are not new are edges of the triangulation,
+// which cross neither one another nor the edges of the polygon. So the cycle
+// is simple if the new edges cross none of the others. The region added to
+// the cavity lies between the old and the new edges, within the box of the
+// edit, so only the edges of the polygon in the box may get into the cavity:
+// those crossing the new edges, or having an end inside.
+bool
+IncrementalTriangulation::check_cavity (const Edit& edit) {
+    const std::size_t k = _cycle.size();
+
+    // Removing an ear leaves no cavity.
+    if (k == 2) return true;
+    if (k < 2) return false;
+
+    const auto grow_across = [this] (const std::size_t c, const std::size_t d) {
+        const std::size_t t = triangle_across (c, d);
+        if (t != npos) _growth.push_back (t);
+    };
+
+    // The cavity turned inside out, e.g., a vertex moved across the far side
+    // of its triangle.
+    if (geometry::signed_area (_cycle_points) <= 0.) {
+        for (std::size_t i = 0; i < k; ++i) grow_across (_cycle[i], _cycle[i + 1 == k ? 0 : i + 1]);
+        return false;
+    }
+
+    bool is_simple = true;
+    for (const auto& [a, b] : edit.new_edges) {
+        for (std::size_t i = 0; i < k; ++i) {
+            const std::size_t c = _cycle[i];
+            const std::size_t d = _cycle[i + 1 == k ? 0 : i + 1];
+            if ((c == a && d == b) || (c == b && d == a)) continue;
+            if (!touch (a, b, c, d)) continue;
+
+            is_simple = false;
+            grow_across (c, d);
+        }
+    }
+    if (!is_simple) return false;
+
+    // An edge whose ends are both on the cycle, and which crosses no edge of
+    // the cycle, is either inside or outside of the cavity as a whole.
+    const auto gets_in = [&] (const std::size_t r, const std::size_t s) {
+        const std::size_t i_r = _cycle_index[r];
+        const std::size_t i_s = _cycle_index[s];
+        if (i_r != npos && i_s != npos) {
+            if ((i_r + 1) % k == i_s || (i_s + 1) % k == i_r) return false;
+            return cavity_contains (geometry::midpoint (_points[r], _points[s]));
+        }
+
+        for (const auto& [a, b] : edit.new_edges) {
+            if (touch (a, b, r, s)) return true;
+        }
+        return (i_r == npos && cavity_contains (_points[r])) ||
+               (i_s == npos && cavity_contains (_points[s]));
+    };
+
+    const bool intrudes = _edges.any_of (edit.box.lower, edit.box.upper, [&] (const std::size_t r) {
+        const std::size_t s = _next[r];
+        if (!gets_in (r, s)) return false;
+
+        // The triangles of the edge are in the way.
+        for (const std::size_t v : {r, s}) {
+            _growth.insert (_growth.end(), _incident[v].begin(), _incident[v].end());
+        }
+        return true;
+    });
+
+    return !intrudes;
+}
+
+std::size_t
+IncrementalTriangulation::triangle_across (const std::size_t c, const std::size_t d) const {
+    for (const std::size_t t : _incident[d]) {
+        const auto [a, b, e] = _triangles[t];
+        if ((a == d && b == c) || (b == d && e == c) || (e == d && a == c)) return t;
+    }
+    return npos;
+}
+
+bool
+IncrementalTriangulation::touch (
+    const std::size_t a,
+    const std::size_t b,
+    const std::size_t c,
+    const std::size_t d
+) const {
+    const Point& p = _points[a];
+    const Point& q = _points[b];
+    const Point& r = _points[c];
+    const Point& s = _points[d];
+
+    if (geometry::does_intersect (p, q, r, s, geometry::LineType::segment, true)) return true;
+
+    // Touching at an end, or overlapping along the same line
+    return (c != a && c != b && is_on_segment (p, q, r)) ||
+           (d != a && d != b && is_on_segment (p, q, s)) ||
+           (a != c && a != d && is_on_segment (r, s, p)) ||
+           (b != c && b != d && is_on_segment (r, s, q));
+}
+
+// Count the edges of the cycle crossing the ray from p to the right.
+bool
+IncrementalTriangulation::cavity_contains (const Point& p) const {
+    bool inside = false;
+    for (std::size_t i = 0; i + 1 < _cycle_points.size(); ++i) {
+        const Point& a = _cycle_points[i];
+        const Point& b = _cycle_points[i + 1];
+        if (is_on_segment (a, b, p)) return true;
+
+        if ((a.y > p.y) != (b.y > p.y)) {
+            const bool is_left = geometry::orientation (a, b, p) > 0.;
+            if (is_left == (b.y > a.y)) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool
+IncrementalTriangulation::triangulate_cavity () {
+    const std::size_t k = _cycle.size();
+    if (k == 2) {
+        for (const std::size_t t : _cavity) remove_triangle (t);
+        return true;
+    }
+
+    const Triangles& triangles = _triangulator.triangulate (PolygonView{_cycle_points}).triangles;
+    if (triangles.size() != k - 2) return false;
+
+    for (const std::size_t t : _cavity) remove_triangle (t);
+    for (const auto& [a, b, c] : triangles) add_triangle (_cycle[a], _cycle[b], _cycle[c]);
+    return true;
+}
+
+void
+IncrementalTriangulation::triangulate_all () {
+    _triangles.clear();
+    _triangle_areas.clear();
+    _free_triangles.clear();
+    for (std::vector<std::size_t>& incident : _incident) incident.clear();
+    _area = 0.;
+
+    // Points along the polygon from any of its vertices
+    std::size_t first = 0;
+    while (_next[first] == npos) ++first;
+
+    std::vector<std::size_t> handles;
+    Points                   ring;
+    handles.reserve (_size);
+    ring.reserve (_size + 1);
+
+    std::size_t v = first;
+    do {
+        handles.push_back (v);
+        ring.push_back (_points[v]);
+        v = _next[v];
+    } while (v != first);
+    ring.push_back (ring.front());
+
+    for (const auto& [a, b, c] : _triangulator.triangulate (PolygonView{ring}).triangles) {
+        add_triangle (handles[a], handles[b], handles[c]);
+    }
+}
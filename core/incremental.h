@@ -0,0 +1,208 @@
+//
+// incremental.h
+//
+// Keep the triangulation of a polygon up to date while its vertices are moved,
+// inserted and removed
+//
+
+#ifndef __INCREMENTAL_H__
+#define __INCREMENTAL_H__
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "core/edge_grid.h"
+#include "core/primitive.h"
+#include "core/triangulator.h"
+
+//// class IncrementalTriangulation
+
+// Triangulation of a polygon being edited, e.g., in an interactive editor.
+//
+// The triangles incident to the edited vertices form a cavity. After an edit,
+// only the cavity is triangulated again, if it is still a simple polygon and
+// no other edge or vertex of the polygon gets into it. The edit takes time in
+// proportion to the number of the triangles in the cavity and of the edges
+// around it, not to the size of the polygon. Otherwise, e.g., when a vertex is
+// moved across the triangles of other vertices, the whole polygon is
+// triangulated again.
+//
+// The vertices are identified by handles, which do not change while the
+// polygon is edited. The handle of a removed vertex may be given to a vertex
+// inserted later.
+//
+// NOTE: if an edit makes the polygon not simple, the triangulation may be
+// incomplete, as that of Polygon.
+class IncrementalTriangulation {
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    // Triangulate the polygon. The points form a closed polygon, i.e., the
+    // first and last elements coincide, as those of Polygon do, and the vertex
+    // i gets the handle i. At least 3 vertices (std::invalid_argument)
+    explicit IncrementalTriangulation (const std::span<const Point> points);
+
+    // Move the vertex v to p.
+    void
+    move_vertex (const std::size_t v, const Point& p);
+
+    // Insert a vertex at p, between the vertex `after` and the next one, and
+    // return its handle.
+    std::size_t
+    insert_vertex (const std::size_t after, const Point& p);
+
+    // Remove the vertex v. At least 3 vertices remain (std::invalid_argument).
+    void
+    remove_vertex (const std::size_t v);
+
+    // The handles given to the edits should be those of the vertices in the
+    // polygon (std::out_of_range).
+    const Point&
+    point (const std::size_t v) const {
+        return _points[v];
+    }
+
+    std::size_t
+    next (const std::size_t v) const {
+        return _next[v];
+    }
+
+    std::size_t
+    prev (const std::size_t v) const {
+        return _prev[v];
+    }
+
+    // Number of vertices
+    std::size_t
+    size () const {
+        return _size;
+    }
+
+    // Points indexed by the handles, including the slots of removed vertices,
+    // which no triangle refers to
+    const Points&
+    points () const {
+        return _points;
+    }
+
+    // Counter-clockwise triangles whose indices are the handles of vertices
+    Triangles
+    triangles () const;
+
+    // Sum of the areas of the triangles
+    double
+    area () const {
+        return _area;
+    }
+
+    // Number of edits which triangulated the whole polygon again
+    std::size_t
+    count_rebuilds () const {
+        return _count_rebuilds;
+    }
+
+  private:
+    using Edge = std::array<std::size_t, 2>;
+
+    // Change of the boundary of the cavity by an edit: the vertex `removed`
+    // is taken out, or the vertex `inserted` is put between `u` and `w`. The
+    // edges `new_edges` of the polygon are new, and the box bounds the old
+    // and the new edges.
+    struct Edit {
+        std::size_t           removed  = npos;
+        std::size_t           inserted = npos;
+        std::size_t           u        = npos;
+        std::size_t           w        = npos;
+        std::span<const Edge> new_edges;
+        BoundingBox           box;
+    };
+
+    void
+    check_vertex (const std::size_t v) const;
+
+    // Allocate the handle of a new vertex.
+    std::size_t
+    new_vertex (const Point& p);
+
+    void
+    add_triangle (const std::size_t a, const std::size_t b, const std::size_t c);
+
+    void
+    remove_triangle (const std::size_t t);
+
+    // Triangulate again the cavity of the triangles after the edit, or the
+    // whole polygon if the cavity cannot be made valid.
+    void
+    update (const Edit& edit, const std::span<const std::size_t> triangles);
+
+    // Trace the boundary of the cavity into the cycle, counter-clockwise.
+    // Returns false if the boundary is not a single cycle, e.g., it touches
+    // itself at a vertex, whose triangles are added to the growth.
+    bool
+    trace_cycle ();
+
+    // Apply the edit to the cycle, and record the position and the point of
+    // every vertex of the cycle. Returns false if the edit does not apply.
+    bool
+    edit_cycle (const Edit& edit);
+
+    // Check whether the cavity can be triangulated again by itself. If not,
+    // the triangles in the way are added to the growth of the cavity.
+    bool
+    check_cavity (const Edit& edit);
+
+    // Triangle on the other side of the edge (c, d) of the cycle, or npos if
+    // the edge is on the boundary of the polygon
+    std::size_t
+    triangle_across (const std::size_t c, const std::size_t d) const;
+
+    // Check whether the line segments (a, b) and (c, d) have any point in
+    // common, other than the ends they share.
+    bool
+    touch (const std::size_t a, const std::size_t b, const std::size_t c, const std::size_t d)
+        const;
+
+    // Check whether the point lies inside the cavity, including its boundary.
+    bool
+    cavity_contains (const Point& p) const;
+
+    // Replace the triangles of the cavity. Returns false if the cavity could
+    // not be triangulated, in which case nothing is changed.
+    bool
+    triangulate_cavity ();
+
+    // Triangulate the whole polygon.
+    void
+    triangulate_all ();
+
+  private:
+    Points                   _points;
+    std::vector<std::size_t> _prev;
+    std::vector<std::size_t> _next;  // npos for removed vertices
+    std::vector<std::size_t> _free_vertices;
+    std::size_t              _size = 0;
+
+    Triangles                             _triangles;  // All npos for removed triangles
+    std::vector<double>                   _triangle_areas;
+    std::vector<std::size_t>              _free_triangles;
+    std::vector<std::vector<std::size_t>> _incident;  // Triangles incident to each vertex
+    double                                _area = 0.;
+
+    EdgeGrid     _edges;  // The edge v connects the vertices v and next(v).
+    Triangulator _triangulator;
+    std::size_t  _count_rebuilds = 0;
+
+    // Workspace of the edits
+    std::vector<std::size_t> _cavity;  // Triangles
+    std::vector<std::size_t> _growth;
+    std::vector<std::size_t> _cycle;
+    std::vector<std::size_t> _cycle_index;  // Position in the cycle, or npos
+    std::vector<std::size_t> _successor;
+    std::vector<Edge>        _boundary;
+    Points                   _cycle_points;  // Closed
+};
+
+#endif
@@ -0,0 +1,455 @@
+#include "core/intersection.h"
+
+#include <bit>
+#include <cstddef>
+
+#include "core/geometry.h"
+#include "core/predicates.h"
+#include "core/simd.h"
+
+//// NAMESPACE: geometry
+namespace geometry {
+
+namespace {
+
+// The line from p to q, in the terms of does_intersect
+struct Line {
+    Point    p;
+    Point    q;
+    LineType line_type;
+};
+
+// Coordinates of the start and the end points of the segments. For the
+// segments of a polyline, the end points are the start points shifted by one.
+struct Segments {
+    const double* r_x;
+    const double* r_y;
+    const double* s_x;
+    const double* s_y;
+};
+
+// Add the segments whose orientations were too close to 0 to be decided in
+// floating point, i.e., the bits of `uncertain`, to the bits of `hit` if
+// does_intersect says they intersect. The segments of the block start at k.
+template <bool Inclusive>
+unsigned
+resolve_uncertain (
+    const Line&       line,
+    const Segments&   segments,
+    const std::size_t k,
+    unsigned          hit,
+    unsigned          uncertain
+) {
+    while (uncertain != 0) {
+        const int i = std::countr_zero (uncertain);
+        uncertain &= uncertain - 1;
+
+        const Point r{segments.r_x[k + i], segments.r_y[k + i]};
+        const Point s{segments.s_x[k + i], segments.s_y[k + i]};
+        if (does_intersect (line.p, line.q, r, s, line.line_type, !Inclusive)) hit |= 1u << i;
+    }
+    return hit;
+}
+
+#ifdef TRIANGULATE_HAS_SSE2
+// predicates::orient2d (a, b, c) in floating point, 2 lanes at once, from the
+// differences a - c and b - c. The lanes of `certain` are set where the sign
+// of the result is correct.
+inline __m128d
+orient2d_sse2 (
+    const __m128d ac_x,
+    const __m128d ac_y,
+    const __m128d bc_x,
+    const __m128d bc_y,
+    __m128d&      certain
+) {
+    const __m128d sign  = _mm_set1_pd (-0.);
+    const __m128d bound = _mm_set1_pd (predicates::orient2d_error_bound);
+
+    const __m128d detleft  = _mm_mul_pd (ac_x, bc_y);
+    const __m128d detright = _mm_mul_pd (ac_y, bc_x);
+    const __m128d det      = _mm_sub_pd (detleft, detright);
+
+    const __m128d permanent =
+        _mm_add_pd (_mm_andnot_pd (sign, detleft), _mm_andnot_pd (sign, detright));
+    certain = _mm_cmpge_pd (_mm_andnot_pd (sign, det), _mm_mul_pd (bound, permanent));
+    return det;
+}
+
+// Test the segments in blocks of 2 from `begin` while a whole block fits
+// before `end`. Returns the index after the last block tested, and adds the
+// number of intersecting segments to `count`. If `stop_at_first`, returns the
+// index of the first intersecting segment instead.
+//
+// The conditions of does_intersect are decided by the signs of the
+// orientations o_r, o_s (of r and s w.r.t. the line) and o_p, o_q (of p and q
+// w.r.t. the segment). The segments with any of them uncertain are tested
+// again by does_intersect.
+template <bool Inclusive>
+std::size_t
+scan_sse2 (
+    const Line&     line,
+    const Segments& segments,
+    std::size_t     begin,
+    std::size_t     end,
+    bool            stop_at_first,
+    std::size_t&    count
+) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d all  = _mm_cmpeq_pd (zero, zero);
+
+    const __m128d p_x  = _mm_set1_pd (line.p.x);
+    const __m128d p_y  = _mm_set1_pd (line.p.y);
+    const __m128d q_x  = _mm_set1_pd (line.q.x);
+    const __m128d q_y  = _mm_set1_pd (line.q.y);
+    const __m128d pq_x = _mm_set1_pd (line.p.x - line.q.x);
+    const __m128d pq_y = _mm_set1_pd (line.p.y - line.q.y);
+
+    // Bounds of a which do not apply to the line type always pass.
+    const __m128d skip_a_lower = line.line_type == LineType::infinite_line ? all : zero;
+    const __m128d skip_a_upper = line.line_type == LineType::segment ? zero : all;
+
+    std::size_t k = begin;
+    for (; k + 2 <= end; k += 2) {
+        const __m128d r_x = _mm_loadu_pd (segments.r_x + k);
+        const __m128d r_y = _mm_loadu_pd (segments.r_y + k);
+        const __m128d s_x = _mm_loadu_pd (segments.s_x + k);
+        const __m128d s_y = _mm_loadu_pd (segments.s_y + k);
+
+        // o_r = orient2d (r, p, q) and o_s = orient2d (s, p, q)
+        __m128d       certain_r, certain_s;
+        const __m128d o_r =
+            orient2d_sse2 (_mm_sub_pd (r_x, q_x), _mm_sub_pd (r_y, q_y), pq_x, pq_y, certain_r);
+        const __m128d o_s =
+            orient2d_sse2 (_mm_sub_pd (s_x, q_x), _mm_sub_pd (s_y, q_y), pq_x, pq_y, certain_s);
+
+        const __m128d pos_r = _mm_cmpgt_pd (o_r, zero);
+        const __m128d neg_r = _mm_cmplt_pd (o_r, zero);
+        const __m128d pos_s = _mm_cmpgt_pd (o_s, zero);
+        const __m128d neg_s = _mm_cmplt_pd (o_s, zero);
+
+        // Sign of the determinant o_r - o_s, where 0 <= b <= 1
+        const __m128d det_pos = _mm_or_pd (pos_r, neg_s);
+        const __m128d det_neg = _mm_or_pd (neg_r, pos_s);
+
+        __m128d b_inside;
+        if constexpr (Inclusive) {
+            b_inside = _mm_andnot_pd (
+                _mm_or_pd (_mm_and_pd (pos_r, pos_s), _mm_and_pd (neg_r, neg_s)),
+                _mm_or_pd (det_pos, det_neg)
+            );
+        } else {
+            b_inside = _mm_or_pd (_mm_and_pd (pos_r, neg_s), _mm_and_pd (neg_r, pos_s));
+        }
+
+        // Most of the segments do not cross the line at all.
+        __m128d certain = _mm_and_pd (certain_r, certain_s);
+        if (_mm_movemask_pd (_mm_or_pd (b_inside, _mm_xor_pd (certain, all))) == 0) continue;
+
+        // o_p = orient2d (p, r, s) and o_q = orient2d (q, r, s)
+        const __m128d rs_x = _mm_sub_pd (r_x, s_x);
+        const __m128d rs_y = _mm_sub_pd (r_y, s_y);
+        __m128d       certain_p, certain_q;
+        const __m128d o_p =
+            orient2d_sse2 (_mm_sub_pd (p_x, s_x), _mm_sub_pd (p_y, s_y), rs_x, rs_y, certain_p);
+        const __m128d o_q =
+            orient2d_sse2 (_mm_sub_pd (q_x, s_x), _mm_sub_pd (q_y, s_y), rs_x, rs_y, certain_q);
+
+        certain = _mm_and_pd (certain, _mm_or_pd (skip_a_lower, certain_p));
+        certain = _mm_and_pd (certain, _mm_or_pd (skip_a_upper, certain_q));
+
+        const __m128d pos_p = _mm_cmpgt_pd (o_p, zero);
+        const __m128d neg_p = _mm_cmplt_pd (o_p, zero);
+        const __m128d pos_q = _mm_cmpgt_pd (o_q, zero);
+        const __m128d neg_q = _mm_cmplt_pd (o_q, zero);
+
+        __m128d a_above_lower, a_below_upper;
+        if constexpr (Inclusive) {
+            a_above_lower =
+                _mm_or_pd (_mm_andnot_pd (pos_p, det_pos), _mm_andnot_pd (neg_p, det_neg));
+            a_below_upper =
+                _mm_or_pd (_mm_andnot_pd (neg_q, det_pos), _mm_andnot_pd (pos_q, det_neg));
+        } else {
+            a_above_lower = _mm_or_pd (_mm_and_pd (neg_p, det_pos), _mm_and_pd (pos_p, det_neg));
+            a_below_upper = _mm_or_pd (_mm_and_pd (pos_q, det_pos), _mm_and_pd (neg_q, det_neg));
+        }
+
+        __m128d hit = _mm_and_pd (certain, b_inside);
+        hit         = _mm_and_pd (hit, _mm_or_pd (skip_a_lower, a_above_lower));
+        hit         = _mm_and_pd (hit, _mm_or_pd (skip_a_upper, a_below_upper));
+
+        unsigned       mask      = static_cast<unsigned> (_mm_movemask_pd (hit));
+        const unsigned uncertain = static_cast<unsigned> (_mm_movemask_pd (certain)) ^ 0x3u;
+        if (uncertain != 0) {
+            mask = resolve_uncertain<Inclusive> (line, segments, k, mask, uncertain);
+        }
+
+        if (mask == 0) continue;
+        if (stop_at_first) {
+            count++;
+            return k + std::countr_zero (mask);
+        }
+        count += std::popcount (mask);
+    }
+    return k;
+}
+#endif
+
+#ifdef TRIANGULATE_HAS_AVX2
+// Same as orient2d_sse2, 4 lanes at once
+TRIANGULATE_AVX2_TARGET inline __m256d
+orient2d_avx2 (
+    const __m256d ac_x,
+    const __m256d ac_y,
+    const __m256d bc_x,
+    const __m256d bc_y,
+    __m256d&      certain
+) {
+    const __m256d sign  = _mm256_set1_pd (-0.);
+    const __m256d bound = _mm256_set1_pd (predicates::orient2d_error_bound);
+
+    const __m256d detleft  = _mm256_mul_pd (ac_x, bc_y);
+    const __m256d detright = _mm256_mul_pd (ac_y, bc_x);
+    const __m256d det      = _mm256_sub_pd (detleft, detright);
+
+    const __m256d permanent =
+        _mm256_add_pd (_mm256_andnot_pd (sign, detleft), _mm256_andnot_pd (sign, detright));
+    certain = _mm256_cmp_pd (
+        _mm256_andnot_pd (sign, det), _mm256_mul_pd (bound, permanent), _CMP_GE_OQ
+    );
+    return det;
+}
+
+// Same as scan_sse2, in blocks of 4
+template <bool Inclusive>
+TRIANGULATE_AVX2_TARGET std::size_t
+scan_avx2 (
+    const Line&     line,
+    const Segments& segments,
+    std::size_t     begin,
+    std::size_t     end,
+    bool            stop_at_first,
+    std::size_t&    count
+) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d all  = _mm256_cmp_pd (zero, zero, _CMP_EQ_OQ);
+
+    const __m256d p_x  = _mm256_set1_pd (line.p.x);
+    const __m256d p_y  = _mm256_set1_pd (line.p.y);
+    const __m256d q_x  = _mm256_set1_pd (line.q.x);
+    const __m256d q_y  = _mm256_set1_pd (line.q.y);
+    const __m256d pq_x = _mm256_set1_pd (line.p.x - line.q.x);
+    const __m256d pq_y = _mm256_set1_pd (line.p.y - line.q.y);
+
+    const __m256d skip_a_lower = line.line_type == LineType::infinite_line ? all : zero;
+    const __m256d skip_a_upper = line.line_type == LineType::segment ? zero : all;
+
+    std::size_t k = begin;
+    for (; k + 4 <= end; k += 4) {
+        const __m256d r_x = _mm256_loadu_pd (segments.r_x + k);
+        const __m256d r_y = _mm256_loadu_pd (segments.r_y + k);
+        const __m256d s_x = _mm256_loadu_pd (segments.s_x + k);
+        const __m256d s_y = _mm256_loadu_pd (segments.s_y + k);
+
+        __m256d       certain_r, certain_s;
+        const __m256d o_r = orient2d_avx2 (
+            _mm256_sub_pd (r_x, q_x), _mm256_sub_pd (r_y, q_y), pq_x, pq_y, certain_r
+        );
+        const __m256d o_s = orient2d_avx2 (
+            _mm256_sub_pd (s_x, q_x), _mm256_sub_pd (s_y, q_y), pq_x, pq_y, certain_s
+        );
+
+        const __m256d pos_r = _mm256_cmp_pd (o_r, zero, _CMP_GT_OQ);
+        const __m256d neg_r = _mm256_cmp_pd (o_r, zero, _CMP_LT_OQ);
+        const __m256d pos_s = _mm256_cmp_pd (o_s, zero, _CMP_GT_OQ);
+        const __m256d neg_s = _mm256_cmp_pd (o_s, zero, _CMP_LT_OQ);
+
+        const __m256d det_pos = _mm256_or_pd (pos_r, neg_s);
+        const __m256d det_neg = _mm256_or_pd (neg_r, pos_s);
+
+        __m256d b_inside;
+        if constexpr (Inclusive) {
+            b_inside = _mm256_andnot_pd (
+                _mm256_or_pd (_mm256_and_pd (pos_r, pos_s), _mm256_and_pd (neg_r, neg_s)),
+                _mm256_or_pd (det_pos, det_neg)
+            );
+        } else {
+            b_inside =
+                _mm256_or_pd (_mm256_and_pd (pos_r, neg_s), _mm256_and_pd (neg_r, pos_s));
+        }
+
+        __m256d certain = _mm256_and_pd (certain_r, certain_s);
+        if (_mm256_movemask_pd (_mm256_or_pd (b_inside, _mm256_xor_pd (certain, all))) == 0)
+            continue;
+
+        const __m256d rs_x = _mm256_sub_pd (r_x, s_x);
+        const __m256d rs_y = _mm256_sub_pd (r_y, s_y);
+        __m256d       certain_p, certain_q;
+        const __m256d o_p = orient2d_avx2 (
+            _mm256_sub_pd (p_x, s_x), _mm256_sub_pd (p_y, s_y), rs_x, rs_y, certain_p
+        );
+        const __m256d o_q = orient2d_avx2 (
+            _mm256_sub_pd (q_x, s_x), _mm256_sub_pd (q_y, s_y), rs_x, rs_y, certain_q
+        );
+
+        certain = _mm256_and_pd (certain, _mm256_or_pd (skip_a_lower, certain_p));
+        certain = _mm256_and_pd (certain, _mm256_or_pd (skip_a_upper, certain_q));
+
+        const __m256d pos_p = _mm256_cmp_pd (o_p, zero, _CMP_GT_OQ);
+        const __m256d neg_p = _mm256_cmp_pd (o_p, zero, _CMP_LT_OQ);
+        const __m256d pos_q = _mm256_cmp_pd (o_q, zero, _CMP_GT_OQ);
+        const __m256d neg_q = _mm256_cmp_pd (o_q, zero, _CMP_LT_OQ);
+
+        __m256d a_above_lower, a_below_upper;
+        if constexpr (Inclusive) {
+            a_above_lower = _mm256_or_pd (
+                _mm256_andnot_pd (pos_p, det_pos), _mm256_andnot_pd (neg_p, det_neg)
+            );
+            a_below_upper = _mm256_or_pd (
+                _mm256_andnot_pd (neg_q, det_pos), _mm256_andnot_pd (pos_q, det_neg)
+            );
+        } else {
+            a_above_lower =
+                _mm256_or_pd (_mm256_and_pd (neg_p, det_pos), _mm256_and_pd (pos_p, det_neg));
+            a_below_upper =
+                _mm256_or_pd (_mm256_and_pd (pos_q, det_pos), _mm256_and_pd (neg_q, det_neg));
+        }
+
+        __m256d hit = _mm256_and_pd (certain, b_inside);
+        hit         = _mm256_and_pd (hit, _mm256_or_pd (skip_a_lower, a_above_lower));
+        hit         = _mm256_and_pd (hit, _mm256_or_pd (skip_a_upper, a_below_upper));
+
+        unsigned       mask      = static_cast<unsigned> (_mm256_movemask_pd (hit));
+        const unsigned uncertain = static_cast<unsigned> (_mm256_movemask_pd (certain)) ^ 0xfu;
+        if (uncertain != 0) {
+            mask = resolve_uncertain<Inclusive> (line, segments, k, mask, uncertain);
+        }
+
+        if (mask == 0) continue;
+        if (stop_at_first) {
+            count++;
+            return k + std::countr_zero (mask);
+        }
+        count += std::popcount (mask);
+    }
+    return k;
+}
+
+bool
+avx2_supported () {
+#ifdef TRIANGULATE_AVX2_RUNTIME_CHECK
+    static const bool supported = __builtin_cpu_supports ("avx2");
+    return supported;
+#else
+    return true;
+#endif
+}
+#endif
+
+// Test the segments from `begin` to `end` - 1 with the widest instructions
+// available, and then the remaining ones one by one.
+std::size_t
+scan (
+    const Point&      p,
+    const Point&      q,
+    const Segments&   segments,
+    const std::size_t begin,
+    const std::size_t end,
+    const LineType    line_type,
+    const bool        ignore_endpoints,
+    const bool        stop_at_first,
+    std::size_t&      count
+) {
+    [[maybe_unused]] const Line line{p, q, line_type};
+
+    std::size_t k = begin;
+#if defined(TRIANGULATE_HAS_AVX2)
+    if (avx2_supported()) {
+        k = ignore_endpoints ? scan_avx2<false> (line, segments, k, end, stop_at_first, count)
+                             : scan_avx2<true> (line, segments, k, end, stop_at_first, count);
+        if (stop_at_first && count > 0) return k;
+    }
+#endif
+#if defined(TRIANGULATE_HAS_SSE2)
+    k = ignore_endpoints ? scan_sse2<false> (line, segments, k, end, stop_at_first, count)
+                         : scan_sse2<true> (line, segments, k, end, stop_at_first, count);
+    if (stop_at_first && count > 0) return k;
+#endif
+
+    for (; k < end; ++k) {
+        const Point r{segments.r_x[k], segments.r_y[k]};
+        const Point s{segments.s_x[k], segments.s_y[k]};
+        if (!does_intersect (p, q, r, s, line_type, ignore_endpoints)) continue;
+        count++;
+        if (stop_at_first) return k;
+    }
+    return k;
+}
+
+// Segments (k, k + 1) of a polyline
+Segments
+segments_of (const PointArrays& polyline) {
+    const double* x = polyline.x.data();
+    const double* y = polyline.y.data();
+    return Segments{x, y, x + 1, y + 1};
+}
+
+}  // namespace
+
+// Index of the first segment (k, k + 1), begin <= k < end, of the polyline
+// which intersects the line from p to q, or `end` if none of them does.
+std::size_t
+find_intersection (
+    const Point&       p,
+    const Point&       q,
+    const PointArrays& polyline,
+    const std::size_t  begin,
+    const std::size_t  end,
+    const LineType     line_type,
+    const bool         ignore_endpoints
+) {
+    std::size_t       count = 0;
+    const std::size_t k =
+        scan (p, q, segments_of (polyline), begin, end, line_type, ignore_endpoints, true, count);
+    return count > 0 ? k : end;
+}
+
+// Index of the first segment (starts[k], ends[k]), begin <= k < end, which
+// intersects the line from p to q, or `end` if none of them does.
+std::size_t
+find_intersection (
+    const Point&       p,
+    const Point&       q,
+    const PointArrays& starts,
+    const PointArrays& ends,
+    const std::size_t  begin,
+    const std::size_t  end,
+    const LineType     line_type,
+    const bool         ignore_endpoints
+) {
+    const Segments segments{starts.x.data(), starts.y.data(), ends.x.data(), ends.y.data()};
+
+    std::size_t       count = 0;
+    const std::size_t k =
+        scan (p, q, segments, begin, end, line_type, ignore_endpoints, true, count);
+    return count > 0 ? k : end;
+}
+
+// Number of the segments (k, k + 1), begin <= k < end, of the polyline which
+// intersect the line from p to q.
+std::size_t
+count_intersections (
+    const Point&       p,
+    const Point&       q,
+    const PointArrays& polyline,
+    const std::size_t  begin,
+    const std::size_t  end,
+    const LineType     line_type,
+    const bool         ignore_endpoints
+) {
+    std::size_t count = 0;
+    scan (p, q, segments_of (polyline), begin, end, line_type, ignore_endpoints, false, count);
+    return count;
+}
+
+}  // namespace geometry
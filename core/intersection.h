@@ -0,0 +1,78 @@
+//
+// intersection.h
+//
+// Batched intersection tests of a line against many segments
+//
+// The segments are the consecutive points (k, k + 1) of a polyline, or the
+// start and end points of separate segments, stored in PointArrays, so a block
+// of them is loaded from contiguous memory and tested at once with SIMD
+// instructions: AVX2 (4 segments) if the processor supports it, SSE2 (2
+// segments) on the other x86 processors, and one by one elsewhere.
+// The orientations are evaluated in floating point with the error bound of
+// predicates::orient2d, and the rare segments whose result is uncertain are
+// tested again by geometry::does_intersect, so the results are exactly the
+// same as those of geometry::does_intersect.
+//
+// The kernel is for the loops testing one line against many segments: the
+// rays counting the crossings of the polygon for WindingMethod::ray_casting,
+// and the moves of random_polygon against the edges gathered from its grid.
+// The ear test of ear clipping does not use it, since it tests whether the
+// few non-convex vertices near an ear lie in the triangle, not segments.
+//
+
+#ifndef __INTERSECTION_H__
+#define __INTERSECTION_H__
+
+#include <cstddef>
+
+#include "core/geometry.h"
+#include "core/primitive.h"
+
+//// NAMESPACE: geometry
+namespace geometry {
+
+// Index of the first segment (k, k + 1), begin <= k < end, of the polyline
+// which intersects the line from p to q, or `end` if none of them does.
+// The conditions are those of does_intersect (p, q, polyline[k], polyline[k + 1],
+// line_type, ignore_endpoints). The polyline should have at least end + 1 points.
+std::size_t
+find_intersection (
+    const Point&       p,
+    const Point&       q,
+    const PointArrays& polyline,
+    const std::size_t  begin,
+    const std::size_t  end,
+    const LineType     line_type        = LineType::segment,
+    const bool         ignore_endpoints = true
+);
+
+// Same as above, for the separate segments (starts[k], ends[k]), e.g., the
+// edges near a point gathered from a spatial index.
+std::size_t
+find_intersection (
+    const Point&       p,
+    const Point&       q,
+    const PointArrays& starts,
+    const PointArrays& ends,
+    const std::size_t  begin,
+    const std::size_t  end,
+    const LineType     line_type        = LineType::segment,
+    const bool         ignore_endpoints = true
+);
+
+// Number of the segments (k, k + 1), begin <= k < end, of the polyline which
+// intersect the line from p to q.
+std::size_t
+count_intersections (
+    const Point&       p,
+    const Point&       q,
+    const PointArrays& polyline,
+    const std::size_t  begin,
+    const std::size_t  end,
+    const LineType     line_type        = LineType::segment,
+    const bool         ignore_endpoints = true
+);
+
+}  // namespace geometry
+
+#endif
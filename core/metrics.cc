@@ -0,0 +1,295 @@
+#include "core/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "core/geometry.h"
+#include "core/predicates.h"
+#include "core/simd.h"
+
+namespace {
+
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+// Sums and extremes over the edges (a, b) and the turns (a, b, c) at their
+// ends b. The coordinates of the areas are relative to the first vertex, to
+// reduce the cancellation error far from the origin.
+struct Accumulator {
+    Point origin;
+
+    double twice_area = 0.;  // Sum of the cross products of the edges
+    double centroid_x = 0.;
+    double centroid_y = 0.;
+    double perimeter  = 0.;
+    Point  lower{infinity, infinity};
+    Point  upper{-infinity, -infinity};
+
+    // Vertices where the polygon turns left or right for certain, where the
+    // turn is within the rounding error, and where the direction of the edges
+    // goes around through the positive x axis
+    double count_left      = 0.;
+    double count_right     = 0.;
+    double count_uncertain = 0.;
+    double count_wraps     = 0.;
+};
+
+// Whether the direction of the edge is in [0, pi)
+bool
+is_upper (const double dx, const double dy) {
+    return dy > 0. || (dy == 0. && dx > 0.);
+}
+
+void
+accumulate (Accumulator& acc, const Point& a, const Point& b, const Point& c) {
+    const double ax = a.x - acc.origin.x;
+    const double ay = a.y - acc.origin.y;
+    const double bx = b.x - acc.origin.x;
+    const double by = b.y - acc.origin.y;
+
+    const double cross = ax * by - ay * bx;
+    acc.twice_area += cross;
+    acc.centroid_x += (ax + bx) * cross;
+    acc.centroid_y += (ay + by) * cross;
+
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    acc.perimeter += std::sqrt (dx * dx + dy * dy);
+
+    acc.lower.x = std::min (acc.lower.x, a.x);
+    acc.lower.y = std::min (acc.lower.y, a.y);
+    acc.upper.x = std::max (acc.upper.x, a.x);
+    acc.upper.y = std::max (acc.upper.y, a.y);
+
+    // The turn is evaluated as predicates::orient2d does, but only its
+    // floating-point filter, which is decided for almost every vertex.
+    const double detleft  = (a.x - c.x) * (b.y - c.y);
+    const double detright = (a.y - c.y) * (b.x - c.x);
+    const double det      = detleft - detright;
+    const double bound =
+        predicates::orient2d_error_bound * (std::abs (detleft) + std::abs (detright));
+    if (det > bound) {
+        acc.count_left++;
+    } else if (det < -bound) {
+        acc.count_right++;
+    } else {
+        acc.count_uncertain++;
+    }
+
+    if (!is_upper (dx, dy) && is_upper (c.x - b.x, c.y - b.y)) acc.count_wraps++;
+}
+
+#ifdef TRIANGULATE_HAS_SSE2
+// The x and the y coordinates of the points p[0] and p[1], each in 2 lanes
+inline void
+load_sse2 (const Point* p, __m128d& x, __m128d& y) {
+    const __m128d p0 = _mm_loadu_pd (&p[0].x);
+    const __m128d p1 = _mm_loadu_pd (&p[1].x);
+    x                = _mm_unpacklo_pd (p0, p1);
+    y                = _mm_unpackhi_pd (p0, p1);
+}
+
+inline double
+sum_sse2 (const __m128d v) {
+    return _mm_cvtsd_f64 (_mm_add_sd (v, _mm_unpackhi_pd (v, v)));
+}
+
+// Same as accumulate, over the edges from 0 to `end` - 1 of the points, 2 at
+// once. Returns the number of the edges accumulated, which is even.
+//
+// The conditions are evaluated as masks, whose lanes are added up as 0 or 1,
+// so the loop has no branch.
+std::size_t
+accumulate_sse2 (Accumulator& acc, const Point* points, const std::size_t end) {
+    const __m128d sign  = _mm_set1_pd (-0.);
+    const __m128d one   = _mm_set1_pd (1.);
+    const __m128d zero  = _mm_setzero_pd();
+    const __m128d bound = _mm_set1_pd (predicates::orient2d_error_bound);
+    const __m128d o_x   = _mm_set1_pd (acc.origin.x);
+    const __m128d o_y   = _mm_set1_pd (acc.origin.y);
+
+    __m128d twice_area      = zero;
+    __m128d centroid_x      = zero;
+    __m128d centroid_y      = zero;
+    __m128d perimeter       = zero;
+    __m128d lower_x         = _mm_set1_pd (acc.lower.x);
+    __m128d lower_y         = _mm_set1_pd (acc.lower.y);
+    __m128d upper_x         = _mm_set1_pd (acc.upper.x);
+    __m128d upper_y         = _mm_set1_pd (acc.upper.y);
+    __m128d count_left      = zero;
+    __m128d count_right     = zero;
+    __m128d count_uncertain = zero;
+    __m128d count_wraps     = zero;
+
+    // Same as is_upper
+    const auto is_upper_sse2 = [&] (const __m128d dx, const __m128d dy) {
+        const __m128d flat = _mm_and_pd (_mm_cmpeq_pd (dy, zero), _mm_cmpgt_pd (dx, zero));
+        return _mm_or_pd (_mm_cmpgt_pd (dy, zero), flat);
+    };
+
+    std::size_t k = 0;
+    for (; k + 2 <= end; k += 2) {
+        __m128d a_x, a_y, b_x, b_y, c_x, c_y;
+        load_sse2 (points + k, a_x, a_y);
+        load_sse2 (points + k + 1, b_x, b_y);
+        load_sse2 (points + k + 2, c_x, c_y);
+
+        const __m128d ax    = _mm_sub_pd (a_x, o_x);
+        const __m128d ay    = _mm_sub_pd (a_y, o_y);
+        const __m128d bx    = _mm_sub_pd (b_x, o_x);
+        const __m128d by    = _mm_sub_pd (b_y, o_y);
+        const __m128d cross = _mm_sub_pd (_mm_mul_pd (ax, by), _mm_mul_pd (ay, bx));
+        twice_area          = _mm_add_pd (twice_area, cross);
+        centroid_x          = _mm_add_pd (centroid_x, _mm_mul_pd (_mm_add_pd (ax, bx), cross));
+        centroid_y          = _mm_add_pd (centroid_y, _mm_mul_pd (_mm_add_pd (ay, by), cross));
+
+        const __m128d dx      = _mm_sub_pd (b_x, a_x);
+        const __m128d dy      = _mm_sub_pd (b_y, a_y);
+        const __m128d squared = _mm_add_pd (_mm_mul_pd (dx, dx), _mm_mul_pd (dy, dy));
+        perimeter             = _mm_add_pd (perimeter, _mm_sqrt_pd (squared));
+
+        lower_x = _mm_min_pd (lower_x, a_x);
+        lower_y = _mm_min_pd (lower_y, a_y);
+        upper_x = _mm_max_pd (upper_x, a_x);
+        upper_y = _mm_max_pd (upper_y, a_y);
+
+        const __m128d detleft  = _mm_mul_pd (_mm_sub_pd (a_x, c_x), _mm_sub_pd (b_y, c_y));
+        const __m128d detright = _mm_mul_pd (_mm_sub_pd (a_y, c_y), _mm_sub_pd (b_x, c_x));
+        const __m128d det      = _mm_sub_pd (detleft, detright);
+        const __m128d permanent =
+            _mm_add_pd (_mm_andnot_pd (sign, detleft), _mm_andnot_pd (sign, detright));
+        const __m128d error = _mm_mul_pd (bound, permanent);
+        const __m128d left  = _mm_cmpgt_pd (det, error);
+        const __m128d right = _mm_cmplt_pd (det, _mm_xor_pd (error, sign));
+        count_left          = _mm_add_pd (count_left, _mm_and_pd (left, one));
+        count_right         = _mm_add_pd (count_right, _mm_and_pd (right, one));
+        count_uncertain =
+            _mm_add_pd (count_uncertain, _mm_andnot_pd (_mm_or_pd (left, right), one));
+
+        const __m128d next_upper = is_upper_sse2 (_mm_sub_pd (c_x, b_x), _mm_sub_pd (c_y, b_y));
+        const __m128d wraps      = _mm_andnot_pd (is_upper_sse2 (dx, dy), next_upper);
+        count_wraps              = _mm_add_pd (count_wraps, _mm_and_pd (wraps, one));
+    }
+
+    const auto min_sse2 = [] (const __m128d v) {
+        return _mm_cvtsd_f64 (_mm_min_sd (v, _mm_unpackhi_pd (v, v)));
+    };
+    const auto max_sse2 = [] (const __m128d v) {
+        return _mm_cvtsd_f64 (_mm_max_sd (v, _mm_unpackhi_pd (v, v)));
+    };
+
+    acc.twice_area += sum_sse2 (twice_area);
+    acc.centroid_x += sum_sse2 (centroid_x);
+    acc.centroid_y += sum_sse2 (centroid_y);
+    acc.perimeter += sum_sse2 (perimeter);
+    acc.lower = Point{min_sse2 (lower_x), min_sse2 (lower_y)};
+    acc.upper = Point{max_sse2 (upper_x), max_sse2 (upper_y)};
+    acc.count_left += sum_sse2 (count_left);
+    acc.count_right += sum_sse2 (count_right);
+    acc.count_uncertain += sum_sse2 (count_uncertain);
+    acc.count_wraps += sum_sse2 (count_wraps);
+
+    return k;
+}
+#endif
+
+// Convexity decided exactly, for the polygons with a turn within the rounding
+// error of the filter, e.g., collinear vertices
+template <typename T>
+bool
+is_convex_exactly (const std::span<const BasicPoint<T>> points, const double count_wraps) {
+    const std::size_t count_vertices = points.size() - 1;
+
+    std::size_t count_left  = 0;
+    std::size_t count_right = 0;
+    for (std::size_t i = 0; i < count_vertices; ++i) {
+        const Point a = to_point (points[i == 0 ? count_vertices - 1 : i - 1]);
+        const Point b = to_point (points[i]);
+        const Point c = to_point (points[i + 1]);
+
+        const double turn = predicates::orient2d (a, b, c);
+        if (turn > 0.) {
+            count_left++;
+        } else if (turn < 0.) {
+            count_right++;
+        } else if ((b.x - a.x) * (c.x - b.x) + (b.y - a.y) * (c.y - b.y) <= 0.) {
+            // Collinear, but going back or not moving
+            return false;
+        }
+    }
+
+    return count_wraps == 1. && (count_left == 0 || count_right == 0);
+}
+
+}  // namespace
+
+//// NAMESPACE: geometry
+namespace geometry {
+
+template <typename T>
+PolygonMetrics
+polygon_metrics (const std::span<const BasicPoint<T>> points) {
+    PolygonMetrics metrics;
+    if (points.size() < 4) {
+        metrics.box = bounding_box (points);
+        return metrics;
+    }
+
+    // The edge k is (k, k + 1), which turns at k + 1 to the edge k + 1. The
+    // last edge turns at the first vertex to the first edge.
+    const std::size_t count_vertices = points.size() - 1;
+
+    Accumulator acc;
+    acc.origin = to_point (points[0]);
+
+    std::size_t k = 0;
+#ifdef TRIANGULATE_HAS_SSE2
+    if constexpr (std::is_same_v<T, double>) {
+        k = accumulate_sse2 (acc, points.data(), count_vertices - 1);
+    }
+#endif
+    for (; k + 1 < count_vertices; ++k) {
+        accumulate (acc, to_point (points[k]), to_point (points[k + 1]), to_point (points[k + 2]));
+    }
+    accumulate (acc, to_point (points[k]), acc.origin, to_point (points[1]));
+
+    metrics.box         = BoundingBox{acc.lower, acc.upper};
+    metrics.signed_area = .5 * acc.twice_area;
+    metrics.perimeter   = acc.perimeter;
+
+    if (acc.twice_area != 0.) {
+        metrics.centroid = Point{
+            acc.origin.x + acc.centroid_x / (3. * acc.twice_area),
+            acc.origin.y + acc.centroid_y / (3. * acc.twice_area)
+        };
+    } else {
+        Point total;
+        for (std::size_t i = 0; i < count_vertices; ++i) total += to_point (points[i]);
+        const auto n     = static_cast<double> (count_vertices);
+        metrics.centroid = Point{total.x / n, total.y / n};
+    }
+
+    const bool one_way = acc.count_left == 0. || acc.count_right == 0.;
+    if (acc.count_uncertain == 0.) {
+        metrics.convex = one_way && acc.count_wraps == 1.;
+    } else {
+        metrics.convex = one_way && is_convex_exactly (points, acc.count_wraps);
+    }
+
+    return metrics;
+}
+
+// Instantiations for PointF, Point and PointI
+template PolygonMetrics polygon_metrics (const std::span<const PointF>);
+template PolygonMetrics polygon_metrics (const std::span<const Point>);
+template PolygonMetrics polygon_metrics (const std::span<const PointI>);
+
+PolygonMetrics
+polygon_metrics (const std::span<const Point> points) {
+    return polygon_metrics<double> (points);
+}
+
+}  // namespace geometry
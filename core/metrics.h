@@ -0,0 +1,53 @@
+//
+// metrics.h
+//
+// Measures of a polygon computed from its vertices, without triangulating it
+//
+
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <span>
+
+#include "core/primitive.h"
+
+//// Struct: PolygonMetrics
+
+struct PolygonMetrics {
+    // Positive if the polygon winds counter-clockwise, and negative if
+    // clockwise (shoelace formula)
+    double signed_area = 0.;
+
+    double perimeter = 0.;
+
+    // Centroid of the area, or the mean of the vertices if the area is zero
+    Point centroid;
+
+    BoundingBox box;
+
+    // Whether the polygon is convex: it turns in one direction at every
+    // vertex, or goes straight, and goes around only once. The turns are
+    // decided exactly, as those of predicates::orient2d.
+    bool convex = false;
+};
+
+//// NAMESPACE: geometry
+namespace geometry {
+
+// Measures of a closed polygon, i.e., the first and last points coincide, as
+// those of Polygon do, in a single pass over the points. The points of double
+// coordinates are accumulated 2 edges at once with SSE2 on x86 processors,
+// and the others one by one.
+//
+// A polygon of less than 3 vertices has only the bounding box.
+template <typename T>
+PolygonMetrics
+polygon_metrics (const std::span<const BasicPoint<T>> points);
+
+// Same as above for points of double coordinates, e.g., a Points vector
+PolygonMetrics
+polygon_metrics (const std::span<const Point> points);
+
+}  // namespace geometry
+
+#endif
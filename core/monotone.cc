@@ -0,0 +1,750 @@
+#include "core/monotone.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <numbers>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "core/geometry.h"
+#include "core/thread_pool.h"
+#include "core/vertex_ring.h"
+
+//// NAMESPACE: monotone
+
+namespace monotone {
+
+namespace {
+
+constexpr std::size_t npos = static_cast<std::size_t> (-1);
+
+// Helper of an edge crossing the top of a slab, until the slabs above are swept
+constexpr std::size_t unknown_helper = npos - 1;
+
+// Order of the sweep: p is above q if p.y > q.y, or p.y == q.y and p.x < q.x.
+// With this order, no two vertices are at the same height, so there is no
+// horizontal edge to take care of.
+template <typename T>
+bool
+is_above (const BasicPoint<T>& p, const BasicPoint<T>& q) {
+    return p.y > q.y || (p.y == q.y && p.x < q.x);
+}
+
+// .start: both neighbors are below, and the interior angle is less than pi
+// .split: both neighbors are below, and the interior angle is greater than pi
+// .end: both neighbors are above, and the interior angle is less than pi
+// .merge: both neighbors are above, and the interior angle is greater than pi
+// .regular: one of the neighbors is above, and the other is below
+enum class VertexType { start, split, end, merge, regular };
+
+//// class Decomposer
+
+// Finds the diagonals splitting a polygon into y-monotone pieces, and collects
+// the boundaries of the pieces.
+//
+// The vertices are visited in counter-clockwise order regardless of the winding
+// of the input, so the interior is always on the left of an edge. An edge is
+// identified by the index of its starting vertex.
+//
+// With a pool of threads, the events are split into horizontal slabs which are
+// swept concurrently. A slab starts with the edges crossing its top, whose
+// helpers are not known until the slabs above are swept. The diagonals to
+// those helpers are put aside, and resolved from top to bottom at the end.
+template <typename T> class Decomposer {
+  public:
+    Decomposer (
+        const std::span<const BasicPoint<T>> points,
+        const std::size_t                    count,
+        const bool                           ccw,
+        ThreadPool* const                    pool
+    )
+        : _points{points}
+        , _ccw{ccw}
+        , _pool{pool}
+        , _count{count}
+        , _ring (count) {}
+
+    Pieces
+    run () {
+        remove_degenerate_vertices();
+        if (_ring.size() < 3) return Pieces{};
+
+        sweep();
+        return collect_pieces();
+    }
+
+  private:
+    // Order of the edges crossing the sweep line, from left to right.
+    //
+    // All edges in the status go downward, and they do not cross each other.
+    // When two edges are compared, the upper end point of one of them is within
+    // the vertical span of the other, so the order is decided by the side of
+    // the edge the point lies on.
+    struct EdgeOrder {
+        using is_transparent = void;
+
+        const Decomposer* self;
+
+        // Whether a point is left of a downward edge
+        bool
+        is_left (const BasicPoint<T>& p, const std::size_t e) const {
+            return geometry::orientation (self->_points[e], self->_points[self->next (e)], p) < 0.;
+        }
+
+        bool
+        is_right (const BasicPoint<T>& p, const std::size_t e) const {
+            return geometry::orientation (self->_points[e], self->_points[self->next (e)], p) > 0.;
+        }
+
+        bool
+        operator() (const std::size_t e1, const std::size_t e2) const {
+            if (e1 == e2) return false;
+
+            const BasicPoint<T>& a1 = self->_points[e1];
+            const BasicPoint<T>& a2 = self->_points[e2];
+
+            if (is_above (a2, a1)) return is_left (a1, e2);
+            return is_right (a2, e1);
+        }
+
+        bool
+        operator() (const std::size_t e, const BasicPoint<T>& p) const {
+            return is_right (p, e);
+        }
+
+        bool
+        operator() (const BasicPoint<T>& p, const std::size_t e) const {
+            return is_left (p, e);
+        }
+    };
+
+    // Edges crossing the sweep line, and their helpers
+    using Status         = std::map<std::size_t, std::size_t, EdgeOrder>;
+    using StatusIterator = typename Status::iterator;
+
+    using Diagonal = std::pair<std::size_t, std::size_t>;
+
+    // Diagonal from a vertex to the helper of an edge, which is not known while
+    // the slab is swept. If `merge_only`, the diagonal is inserted only if the
+    // helper turns out to be a merge vertex.
+    struct PendingDiagonal {
+        std::size_t vertex;
+        std::size_t edge;
+        bool        merge_only;
+    };
+
+    // Events from begin to end - 1 in the order of the sweep
+    struct Slab {
+        std::size_t                  begin;
+        std::size_t                  end;
+        std::vector<std::size_t>     top_edges;  // Edges crossing the top
+        std::vector<Diagonal>        diagonals;
+        std::vector<PendingDiagonal> pending;
+
+        // Edges crossing the bottom, and their helpers
+        std::vector<Diagonal> bottom_helpers;
+    };
+
+    // Call task(i) for every i in [0, count), with the threads if any.
+    void
+    parallel_for (const std::size_t count, const std::function<void (std::size_t)>& task) const {
+        if (_pool) {
+            _pool->for_each (count, task);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) task (i);
+        }
+    }
+
+    std::size_t
+    next (const std::size_t idx) const {
+        return _ccw ? _ring.next (idx) : _ring.prev (idx);
+    }
+
+    std::size_t
+    prev (const std::size_t idx) const {
+        return _ccw ? _ring.prev (idx) : _ring.next (idx);
+    }
+
+    // Remove the duplicated points and the tips of the spikes, i.e., the
+    // vertices whose two edges overlap. Removing a vertex may make its neighbors
+    // degenerate, so they are checked again.
+    void
+    remove_degenerate_vertices () {
+        const auto is_degenerate = [this] (const std::size_t idx) {
+            const BasicPoint<T>& p = _points[prev (idx)];
+            const BasicPoint<T>& v = _points[idx];
+            const BasicPoint<T>& n = _points[next (idx)];
+
+            if (v == n || v == p) return true;
+            return geometry::orientation (p, v, n) == 0. &&
+                   (p.x - v.x) * (n.x - v.x) + (p.y - v.y) * (n.y - v.y) > 0;
+        };
+
+        std::vector<std::size_t> candidates (_count);
+        std::iota (candidates.begin(), candidates.end(), 0);
+
+        while (!candidates.empty() && _ring.size() >= 3) {
+            const std::size_t idx = candidates.back();
+            candidates.pop_back();
+
+            if (!_ring.contains (idx) || !is_degenerate (idx)) continue;
+
+            const std::size_t p = prev (idx);
+            const std::size_t n = next (idx);
+            _ring.remove (idx);
+            candidates.push_back (p);
+            candidates.push_back (n);
+        }
+    }
+
+    VertexType
+    vertex_type (const std::size_t idx) const {
+        const BasicPoint<T>& p = _points[prev (idx)];
+        const BasicPoint<T>& v = _points[idx];
+        const BasicPoint<T>& n = _points[next (idx)];
+
+        const bool prev_below = is_above (v, p);
+        const bool next_below = is_above (v, n);
+        const bool convex     = geometry::orientation (p, v, n) > 0.;
+
+        if (prev_below && next_below) return convex ? VertexType::start : VertexType::split;
+        if (!prev_below && !next_below) return convex ? VertexType::end : VertexType::merge;
+        return VertexType::regular;
+    }
+
+    // Sort the events in the order of the sweep. With the threads, the chunks
+    // of the events are sorted concurrently, and then merged pairwise.
+    void
+    sort_events (std::vector<std::size_t>& events) const {
+        const auto order = [this] (const std::size_t a, const std::size_t b) {
+            if (_points[a] == _points[b]) return a < b;
+            return is_above (_points[a], _points[b]);
+        };
+
+        const std::size_t count_chunks = _pool ? _pool->size() : 1;
+        if (count_chunks == 1) {
+            std::sort (events.begin(), events.end(), order);
+            return;
+        }
+
+        std::vector<std::size_t> bounds (count_chunks + 1);
+        for (std::size_t i = 0; i <= count_chunks; ++i) {
+            bounds[i] = events.size() * i / count_chunks;
+        }
+        const auto at = [&] (const std::size_t chunk) {
+            return events.begin() + bounds[std::min (chunk, count_chunks)];
+        };
+
+        parallel_for (count_chunks, [&] (const std::size_t i) {
+            std::sort (at (i), at (i + 1), order);
+        });
+        for (std::size_t width = 1; width < count_chunks; width *= 2) {
+            parallel_for ((count_chunks + 2 * width - 1) / (2 * width), [&] (const std::size_t i) {
+                const std::size_t first = 2 * width * i;
+                std::inplace_merge (at (first), at (first + width), at (first + 2 * width), order);
+            });
+        }
+    }
+
+    void
+    sweep () {
+        std::vector<std::size_t> events;
+        events.reserve (_ring.size());
+
+        _types.resize (_count);
+        for (std::size_t i = 0; i < _count; ++i) {
+            if (!_ring.contains (i)) continue;
+            events.push_back (i);
+            _types[i] = vertex_type (i);
+        }
+        sort_events (events);
+
+        _rank.assign (_count, npos);
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            _rank[events[i]] = i;
+        }
+        _location.resize (_count);
+        _in_status.assign (_count, false);
+
+        const std::size_t count_slabs = _pool ? std::min (_pool->size(), events.size()) : 1;
+        std::vector<Slab> slabs (count_slabs);
+        for (std::size_t i = 0; i < count_slabs; ++i) {
+            slabs[i].begin = events.size() * i / count_slabs;
+            slabs[i].end   = events.size() * (i + 1) / count_slabs;
+        }
+
+        // An edge going downward is in the status while the sweep line is
+        // between its end points, so it crosses the tops of the slabs there.
+        for (const std::size_t v : events) {
+            const std::size_t w = next (v);
+            if (!is_above (_points[v], _points[w])) continue;
+
+            auto slab = std::upper_bound (
+                slabs.begin(), slabs.end(), _rank[v],
+                [] (const std::size_t r, const Slab& slab) { return r < slab.begin; }
+            );
+            for (; slab != slabs.end() && slab->begin <= _rank[w]; ++slab) {
+                slab->top_edges.push_back (v);
+            }
+        }
+
+        parallel_for (count_slabs, [&] (const std::size_t i) { sweep_slab (events, slabs[i]); });
+
+        // Resolve the pending diagonals from top to bottom. helper[e] is the
+        // helper of the edge e at the top of the current slab.
+        std::vector<std::size_t> helper (_count, npos);
+        for (Slab& slab : slabs) {
+            for (const auto& [v, e, merge_only] : slab.pending) {
+                if (helper[e] == npos) continue;  // Not simple
+                if (!merge_only || _types[helper[e]] == VertexType::merge) {
+                    slab.diagonals.emplace_back (v, helper[e]);
+                }
+            }
+            for (const auto& [e, h] : slab.bottom_helpers) {
+                if (h != unknown_helper) helper[e] = h;
+            }
+            _diagonals.insert (_diagonals.end(), slab.diagonals.begin(), slab.diagonals.end());
+        }
+    }
+
+    // Sweep the events of a slab. An edge may be in the status of several
+    // slabs, but it is erased in only one of them, and only that slab keeps the
+    // location of the edge in its status.
+    void
+    sweep_slab (const std::vector<std::size_t>& events, Slab& slab) {
+        Status status (EdgeOrder{this});
+
+        // Keep the location of an edge if it is erased in this slab. If the
+        // polygon is not simple, an edge may touch another one in the status
+        // and not be inserted, and then it is not erased either.
+        const auto keep_location = [&] (const std::size_t e, const StatusIterator it) {
+            if (it->first != e || _rank[next (e)] >= slab.end) return;
+            _location[e]  = it;
+            _in_status[e] = true;
+        };
+
+        const auto insert_edge = [&] (const std::size_t e, const std::size_t helper) {
+            keep_location (e, status.emplace (e, helper).first);
+        };
+
+        std::sort (slab.top_edges.begin(), slab.top_edges.end(), EdgeOrder{this});
+        for (const std::size_t e : slab.top_edges) {
+            keep_location (e, status.emplace_hint (status.end(), e, unknown_helper));
+        }
+
+        // Connect the vertex to the helper of the edge if the helper is a merge
+        // vertex.
+        const auto connect_merge_helper = [&] (const std::size_t v, const StatusIterator it) {
+            if (it == status.end()) return;
+            if (it->second == unknown_helper) {
+                slab.pending.push_back (PendingDiagonal{v, it->first, true});
+            } else if (_types[it->second] == VertexType::merge) {
+                slab.diagonals.emplace_back (v, it->second);
+            }
+        };
+
+        // The edge directly left of the vertex, or end() if there is none
+        // (which happens only if the polygon is not simple).
+        const auto edge_left_of = [&] (const std::size_t v) {
+            auto it = status.lower_bound (_points[v]);
+            return it == status.begin() ? status.end() : std::prev (it);
+        };
+
+        const auto erase_edge = [&] (const std::size_t v, const std::size_t e) {
+            if (!_in_status[e]) return;  // Not simple
+            connect_merge_helper (v, _location[e]);
+            status.erase (_location[e]);
+            _in_status[e] = false;
+        };
+
+        for (std::size_t i = slab.begin; i < slab.end; ++i) {
+            const std::size_t v      = events[i];
+            const std::size_t e_prev = prev (v);  // Edge (prev(v), v)
+            const std::size_t e_next = v;         // Edge (v, next(v))
+
+            switch (_types[v]) {
+            case VertexType::start: insert_edge (e_next, v); break;
+
+            case VertexType::end: erase_edge (v, e_prev); break;
+
+            case VertexType::split: {
+                const auto left = edge_left_of (v);
+                if (left != status.end()) {
+                    if (left->second == unknown_helper) {
+                        slab.pending.push_back (PendingDiagonal{v, left->first, false});
+                    } else {
+                        slab.diagonals.emplace_back (v, left->second);
+                    }
+                    left->second = v;
+                }
+                insert_edge (e_next, v);
+                break;
+            }
+
+            case VertexType::merge: {
+                erase_edge (v, e_prev);
+
+                const auto left = edge_left_of (v);
+                connect_merge_helper (v, left);
+                if (left != status.end()) left->second = v;
+                break;
+            }
+
+            case VertexType::regular:
+                if (is_above (_points[prev (v)], _points[v])) {
+                    // The boundary goes downward, so the interior is right of v.
+                    erase_edge (v, e_prev);
+                    insert_edge (e_next, v);
+                } else {
+                    const auto left = edge_left_of (v);
+                    connect_merge_helper (v, left);
+                    if (left != status.end()) left->second = v;
+                }
+                break;
+            }
+        }
+
+        slab.bottom_helpers.assign (status.begin(), status.end());
+    }
+
+    // Walk the boundaries of the pieces. Leaving a vertex w which was entered
+    // from u, the boundary of the piece takes the first edge clockwise from
+    // (w, u). The edges at w, from (w, prev(w)) to (w, next(w)) clockwise,
+    // span the interior of the polygon, and the diagonals lie between them.
+    Pieces
+    collect_pieces () {
+        const std::size_t count = _count;
+
+        // Diagonals at every vertex in compressed rows, sorted clockwise.
+        std::sort (_diagonals.begin(), _diagonals.end(), [] (const auto& a, const auto& b) {
+            return std::minmax (a.first, a.second) < std::minmax (b.first, b.second);
+        });
+        _diagonals.erase (
+            std::unique (
+                _diagonals.begin(),
+                _diagonals.end(),
+                [] (const auto& a, const auto& b) {
+                    return std::minmax (a.first, a.second) == std::minmax (b.first, b.second);
+                }
+            ),
+            _diagonals.end()
+        );
+
+        std::vector<std::size_t> offsets (count + 1, 0);
+        for (const auto& [a, b] : _diagonals) {
+            offsets[a + 1]++;
+            offsets[b + 1]++;
+        }
+        for (std::size_t i = 0; i < count; ++i) offsets[i + 1] += offsets[i];
+
+        std::vector<std::size_t> targets (offsets.back());
+        {
+            std::vector<std::size_t> fill (offsets.begin(), offsets.end() - 1);
+            for (const auto& [a, b] : _diagonals) {
+                targets[fill[a]++] = b;
+                targets[fill[b]++] = a;
+            }
+        }
+
+        const auto sort_clockwise = [&] (const std::size_t w) {
+            if (offsets[w + 1] - offsets[w] < 2) return;
+
+            const Point o = to_point (_points[w]);
+            const Point p = to_point (_points[prev (w)]);
+            const Point r{p.x - o.x, p.y - o.y};
+
+            // Clockwise angle from (w, prev(w)) to (w, x)
+            const auto clockwise_angle = [&] (const std::size_t x) {
+                const Point  s = to_point (_points[x]);
+                const Point  d{s.x - o.x, s.y - o.y};
+                const double q = std::atan2 (r.x * d.y - r.y * d.x, r.x * d.x + r.y * d.y);
+                return q <= 0. ? -q : 2. * std::numbers::pi - q;
+            };
+
+            std::sort (
+                targets.begin() + offsets[w],
+                targets.begin() + offsets[w + 1],
+                [&] (const std::size_t a, const std::size_t b) {
+                    return clockwise_angle (a) < clockwise_angle (b);
+                }
+            );
+        };
+
+        const std::size_t count_chunks = _pool ? _pool->size() : 1;
+        parallel_for (count_chunks, [&] (const std::size_t i) {
+            const std::size_t end = count * (i + 1) / count_chunks;
+            for (std::size_t w = count * i / count_chunks; w < end; ++w) {
+                sort_clockwise (w);
+            }
+        });
+
+        // Edge leaving w after entering it from u: (target, slot), where slot
+        // is the position in `targets` or npos for the boundary edge.
+        const auto leaving_edge = [&] (const std::size_t u, const std::size_t w) {
+            std::size_t slot = offsets[w];
+            if (u != prev (w)) {
+                while (slot < offsets[w + 1] && targets[slot] != u) ++slot;
+                ++slot;
+            }
+            if (slot < offsets[w + 1]) return std::make_pair (targets[slot], slot);
+            return std::make_pair (next (w), npos);
+        };
+
+        std::vector<bool> boundary_visited (count, false);
+        std::vector<bool> diagonal_visited (targets.size(), false);
+
+        Pieces pieces;
+        pieces.vertices.reserve (_ring.size() + 2 * _diagonals.size());
+        pieces.offsets.reserve (_diagonals.size() + 2);
+
+        const auto walk = [&] (std::size_t u, std::size_t w) {
+            while (true) {
+                pieces.vertices.push_back (u);
+
+                const auto [x, slot] = leaving_edge (u, w);
+                if (slot == npos) {
+                    if (boundary_visited[w]) break;
+                    boundary_visited[w] = true;
+                } else {
+                    if (diagonal_visited[slot]) break;
+                    diagonal_visited[slot] = true;
+                }
+                u = w;
+                w = x;
+            }
+            pieces.offsets.push_back (pieces.vertices.size());
+        };
+
+        for (std::size_t v = 0; v < count; ++v) {
+            if (!_ring.contains (v)) continue;
+
+            if (!boundary_visited[v]) {
+                boundary_visited[v] = true;
+                walk (v, next (v));
+            }
+            for (std::size_t slot = offsets[v]; slot < offsets[v + 1]; ++slot) {
+                if (diagonal_visited[slot]) continue;
+                diagonal_visited[slot] = true;
+                walk (v, targets[slot]);
+            }
+        }
+
+        return pieces;
+    }
+
+  private:
+    const std::span<const BasicPoint<T>> _points;
+    const bool                           _ccw;
+    ThreadPool* const                    _pool;
+    const std::size_t                    _count;
+    VertexRing                           _ring;
+
+    std::vector<VertexType>     _types;
+    std::vector<std::size_t>    _rank;  // Position of every vertex in the sweep
+    std::vector<StatusIterator> _location;
+    std::vector<char>           _in_status;  // Whether _location is valid, by edge
+    std::vector<Diagonal>       _diagonals;
+};
+
+}  // namespace
+
+// Decompose a simple polygon of the first `count` points into y-monotone
+// pieces.
+template <typename T>
+Pieces
+decompose (
+    const std::span<const BasicPoint<T>> points,
+    const std::size_t                    count,
+    const bool                           ccw,
+    ThreadPool* const                    pool
+) {
+    if (count < 3) return Pieces{};
+    return Decomposer<T>{points, count, ccw, pool}.run();
+}
+
+// Triangulate a y-monotone piece in linear time, and append the triangles.
+//
+// The vertices are merged from the left and right chains in the order of the
+// sweep. The vertices which are not triangulated yet are kept in a stack, and
+// they form a reflex chain on one side.
+template <typename T>
+void
+triangulate_piece (
+    const std::span<const BasicPoint<T>> points,
+    const std::span<const std::size_t>   piece,
+    Triangles&                           triangles
+) {
+    const std::size_t k = piece.size();
+    if (k < 3) return;
+
+    const auto add_triangle = [&] (std::size_t a, std::size_t b, std::size_t c) {
+        if (geometry::orientation (points[a], points[b], points[c]) < 0.) std::swap (b, c);
+        triangles.push_back (TriangleSpec{a, b, c});
+    };
+
+    if (k == 3) {
+        add_triangle (piece[0], piece[1], piece[2]);
+        return;
+    }
+
+    std::size_t top    = 0;
+    std::size_t bottom = 0;
+    for (std::size_t i = 1; i < k; ++i) {
+        if (is_above (points[piece[i]], points[piece[top]])) top = i;
+        if (is_above (points[piece[bottom]], points[piece[i]])) bottom = i;
+    }
+
+    // Merge the chains. Going counter-clockwise from the top, the left chain
+    // comes first. The second of the pair is true for the left chain.
+    using ChainVertex = std::pair<std::size_t, bool>;
+
+    std::vector<ChainVertex> order;
+    order.reserve (k);
+    order.emplace_back (piece[top], true);
+
+    std::size_t l = (top + 1) % k;
+    std::size_t r = (top + k - 1) % k;
+    while (l != bottom || r != bottom) {
+        if (l != bottom && (r == bottom || is_above (points[piece[l]], points[piece[r]]))) {
+            order.emplace_back (piece[l], true);
+            l = (l + 1) % k;
+        } else {
+            order.emplace_back (piece[r], false);
+            r = (r + k - 1) % k;
+        }
+    }
+    order.emplace_back (piece[bottom], false);
+
+    std::vector<ChainVertex> stack{order[0], order[1]};
+    stack.reserve (k);
+
+    for (std::size_t j = 2; j + 1 < k; ++j) {
+        const ChainVertex u = order[j];
+
+        if (u.second != stack.back().second) {
+            // Connect u to all vertices in the stack.
+            for (std::size_t i = 0; i + 1 < stack.size(); ++i) {
+                add_triangle (u.first, stack[i].first, stack[i + 1].first);
+            }
+            stack.clear();
+            stack.push_back (order[j - 1]);
+            stack.push_back (u);
+        } else {
+            // Connect u to the vertices in the stack as long as the diagonals
+            // are inside the piece.
+            ChainVertex last = stack.back();
+            stack.pop_back();
+
+            while (!stack.empty()) {
+                const ChainVertex t = stack.back();
+                const double      o =
+                    geometry::orientation (points[t.first], points[last.first], points[u.first]);
+                if (u.second ? o <= 0. : o >= 0.) break;
+
+                add_triangle (u.first, last.first, t.first);
+                last = t;
+                stack.pop_back();
+            }
+            stack.push_back (last);
+            stack.push_back (u);
+        }
+    }
+
+    // Connect the bottom to all vertices in the stack.
+    const ChainVertex u = order[k - 1];
+    for (std::size_t i = 0; i + 1 < stack.size(); ++i) {
+        add_triangle (u.first, stack[i].first, stack[i + 1].first);
+    }
+}
+
+// Triangulate a simple polygon of the first `count` points.
+template <typename T>
+Triangles
+triangulate (const std::span<const BasicPoint<T>> points, const std::size_t count, const bool ccw) {
+    const Pieces pieces = decompose (points, count, ccw);
+
+    Triangles triangles;
+    triangles.reserve (count > 2 ? count - 2 : 0);
+    for (std::size_t i = 0; i < pieces.size(); ++i) {
+        triangulate_piece (points, pieces[i], triangles);
+    }
+    return triangles;
+}
+
+// Triangulate the pieces with the threads of the pool.
+//
+// The pieces are grouped into runs of about the same number of vertices, a few
+// runs per thread, so that a thread finishing early can steal the remaining
+// ones. Each run appends to its own list, and the lists are joined in the order
+// of the runs.
+template <typename T>
+Triangles
+triangulate (
+    const std::span<const BasicPoint<T>> points,
+    const std::size_t                    count,
+    const bool                           ccw,
+    ThreadPool&                          pool
+) {
+    const Pieces pieces = decompose (points, count, ccw, &pool);
+
+    constexpr std::size_t runs_per_thread = 4;
+    const std::size_t     count_runs      = std::min (pieces.size(), pool.size() * runs_per_thread);
+    if (count_runs <= 1) {
+        Triangles triangles;
+        for (std::size_t i = 0; i < pieces.size(); ++i) {
+            triangulate_piece (points, pieces[i], triangles);
+        }
+        return triangles;
+    }
+
+    // Run r consists of the pieces first[r], ..., first[r + 1] - 1. A run ends
+    // where the pieces so far have r + 1 runs' share of the vertices.
+    std::vector<std::size_t> first{0};
+    const std::size_t        count_piece_vertices = pieces.vertices.size();
+    for (std::size_t i = 0; i < pieces.size(); ++i) {
+        if (pieces.offsets[i + 1] * count_runs >= first.size() * count_piece_vertices) {
+            first.push_back (i + 1);
+        }
+    }
+
+    std::vector<Triangles> runs (first.size() - 1);
+    pool.for_each (runs.size(), [&] (const std::size_t r) {
+        for (std::size_t i = first[r]; i < first[r + 1]; ++i) {
+            triangulate_piece (points, pieces[i], runs[r]);
+        }
+    });
+
+    Triangles triangles;
+    triangles.reserve (count > 2 ? count - 2 : 0);
+    for (const Triangles& run : runs) {
+        triangles.insert (triangles.end(), run.begin(), run.end());
+    }
+    return triangles;
+}
+
+// Instantiations for PointF, Point and PointI
+#define INSTANTIATE_MONOTONE(P)                                                                    \
+    template Pieces decompose (                                                                    \
+        const std::span<const P>, const std::size_t, const bool, ThreadPool* const                 \
+    );                                                                                             \
+    template void triangulate_piece (                                                              \
+        const std::span<const P>, const std::span<const std::size_t>, Triangles&                   \
+    );                                                                                             \
+    template Triangles triangulate (const std::span<const P>, const std::size_t, const bool);      \
+    template Triangles triangulate (                                                               \
+        const std::span<const P>, const std::size_t, const bool, ThreadPool&                       \
+    );
+
+INSTANTIATE_MONOTONE (PointF)
+INSTANTIATE_MONOTONE (Point)
+INSTANTIATE_MONOTONE (PointI)
+
+#undef INSTANTIATE_MONOTONE
+
+}  // namespace monotone
@@ -0,0 +1,92 @@
+//
+// monotone.h
+//
+// Triangulation by decomposition into y-monotone pieces
+//
+// A sweep line moving downward inserts diagonals which split the polygon into
+// y-monotone pieces (de Berg et al., Computational Geometry, Ch. 3). Each piece
+// is then triangulated in linear time, so the whole triangulation takes
+// O(n log n) time in the worst case.
+//
+
+#ifndef __MONOTONE_H__
+#define __MONOTONE_H__
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "core/primitive.h"
+#include "core/thread_pool.h"
+
+//// NAMESPACE: monotone
+
+namespace monotone {
+
+// Monotone pieces of a polygon. The vertices of the i-th piece are
+// vertices[offsets[i]], ..., vertices[offsets[i + 1] - 1] in counter-clockwise
+// order.
+struct Pieces {
+    std::vector<std::size_t> vertices;
+    std::vector<std::size_t> offsets{0};
+
+    std::size_t
+    size () const {
+        return offsets.size() - 1;
+    }
+
+    std::span<const std::size_t>
+    operator[] (const std::size_t i) const {
+        return {vertices.data() + offsets[i], offsets[i + 1] - offsets[i]};
+    }
+};
+
+// The functions are instantiated for PointF, Point and PointI.
+
+// Decompose a simple polygon of the first `count` points into y-monotone
+// pieces. The points wind counter-clockwise if `ccw` is true, and clockwise
+// otherwise. The degenerate vertices, i.e., the duplicated points and the tips
+// of the spikes, do not belong to any piece.
+//
+// With a pool, the sweep is split into horizontal slabs swept by the threads.
+// The pieces are the same either way.
+template <typename T>
+Pieces
+decompose (
+    const std::span<const BasicPoint<T>> points,
+    const std::size_t                    count,
+    const bool                           ccw,
+    ThreadPool* const                    pool = nullptr
+);
+
+// Triangulate a y-monotone piece in linear time, and append the triangles.
+// The vertices of each triangle wind counter-clockwise.
+template <typename T>
+void
+triangulate_piece (
+    const std::span<const BasicPoint<T>> points,
+    const std::span<const std::size_t>   piece,
+    Triangles&                           triangles
+);
+
+// Triangulate a simple polygon of the first `count` points. The points wind
+// counter-clockwise if `ccw` is true, and clockwise otherwise. The vertices of
+// each triangle wind counter-clockwise regardless.
+template <typename T>
+Triangles
+triangulate (const std::span<const BasicPoint<T>> points, const std::size_t count, const bool ccw);
+
+// Triangulate as above, with the threads of the pool for both decomposing the
+// polygon and triangulating the pieces.
+template <typename T>
+Triangles
+triangulate (
+    const std::span<const BasicPoint<T>> points,
+    const std::size_t                    count,
+    const bool                           ccw,
+    ThreadPool&                          pool
+);
+
+}  // namespace monotone
+
+#endif
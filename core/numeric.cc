@@ -11,4 +11,10 @@ close_enough (const double a, const double b, const double eps) {
     return std::abs (a - b) < eps;
 }
 
+// Sign of a scalar: -1, 0 or 1
+int
+sign (const double a) {
+    return (a > 0.) - (a < 0.);
+}
+
 }  // namespace numeric
@@ -14,6 +14,10 @@ namespace numeric {
 bool
 close_enough (const double a, const double b, const double eps = 1e-12);
 
+// Sign of a scalar: -1, 0 or 1
+int
+sign (const double a);
+
 }  // namespace numeric
 
 #endif
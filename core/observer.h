@@ -0,0 +1,49 @@
+//
+// observer.h
+//
+// Interface to observe the steps of a triangulation
+//
+
+#ifndef __OBSERVER_H__
+#define __OBSERVER_H__
+
+#include <span>
+
+#include "core/primitive.h"
+#include "core/vertex_ring.h"
+
+//// class TriangulationObserver
+
+// An observer is notified of the progress of a triangulation, e.g., to draw
+// every step of it. No observer is attached by default, and each callback does
+// nothing unless overridden.
+//
+// The observer is called from the thread running the triangulation. The
+// arguments are valid only during the call.
+class TriangulationObserver {
+  public:
+    virtual ~TriangulationObserver () = default;
+
+    // Called before the first ear is clipped.
+    virtual void
+    on_begin ([[maybe_unused]] const std::span<const Point> points) {}
+
+    // Called whenever a triangle is registered. The ring still contains the
+    // vertex of the ear clipped, and the triangles include the new one.
+    virtual void
+    on_ear_clipped (
+        [[maybe_unused]] const std::span<const Point> points,
+        [[maybe_unused]] const VertexRing&            ring,
+        [[maybe_unused]] const Triangles&             triangles
+    ) {}
+
+    // Called after the last triangle is registered.
+    virtual void
+    on_end (
+        [[maybe_unused]] const std::span<const Point> points,
+        [[maybe_unused]] const VertexRing&            ring,
+        [[maybe_unused]] const Triangles&             triangles
+    ) {}
+};
+
+#endif
@@ -1,195 +1,395 @@
 #include "core/polygon.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <iterator>
-#include <numbers>
-#include <optional>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
 #include <ranges>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#include "core/fileio.h"
+#include "core/cache.h"
 #include "core/geometry.h"
+#include "core/intersection.h"
+#include "core/monotone.h"
 #include "core/numeric.h"
+#include "core/predicates.h"
 #include "core/random.h"
+#include "core/spatial_grid.h"
+#include "core/trace.h"
+#include "core/vertex_ring.h"
+
+namespace {
+
+// Cast random rays from the mid-point of every edge toward the left side, and
+// count the crossings with the polygon. If most of the rays cross the polygon
+// odd times, the left side of the edge is the interior, i.e., the polygon winds
+// counter-clockwise.
+WindingDirection
+winding_direction_by_ray_casting (const std::span<const Point> points) {
+    constexpr int count_random_rays = 32;
+
+    const PointArrays polyline{points};
+    const std::size_t count_edges = points.size() - 1;
+    for (std::size_t i : std::views::iota (0, static_cast<int> (count_edges))) {
+        const Point  p     = geometry::midpoint (points[i], points[i + 1]);
+        const double angle = geometry::angle (points[i], points[i + 1]);
+
+        // Seeded with the index of the edge, so the rays are the same from
+        // run to run.
+        random_point_around_semicircle random_point{angle, i};
+        int                            count_interior_ray = 0;
+
+        for ([[maybe_unused]] auto _ : std::views::iota (0, count_random_rays)) {
+            const Point q = random_point() + p;
+
+            // Includes point p which intersects current segment
+            const std::size_t count_intersections =
+                1 +
+                geometry::count_intersections (
+                    p, q, polyline, 0, i, geometry::LineType::ray, false
+                ) +
+                geometry::count_intersections (
+                    p, q, polyline, i + 1, count_edges, geometry::LineType::ray, false
+                );
+            if (count_intersections % 2 == 0) count_interior_ray++;
+        }
+        constexpr double threshold = 0.2;
+        if (threshold * count_random_rays < count_interior_ray &&
+            count_interior_ray < (1. - threshold) * count_random_rays)
+            continue;
+
+        if (count_interior_ray > (1. - threshold) * count_random_rays) {
+            return WindingDirection::ccw;
+        } else if (count_interior_ray < threshold * count_random_rays) {
+            return WindingDirection::cw;
+        }
+        return WindingDirection::unknown;
+    }
 
-Polygon::Polygon (Points&& pts)
-    : _points{pts} {
-    determine_winding_direction (_points);
+    return WindingDirection::unknown;
 }
 
-Polygon::~Polygon () {
-    if (_debug_tex_tikz_file.is_open()) _debug_tex_tikz_file.close();
+// Vertices of the polygon relative to the first one, which are the same for
+// the translated copies of the polygon. If a difference is not exact in
+// double, the vertices themselves are taken instead, so that polygons of the
+// same shape are always congruent exactly.
+template <typename T>
+void
+shape_of (const std::span<const BasicPoint<T>> points, std::pmr::vector<Point>& shape) {
+    const std::size_t count_vertices = points.size() - 1;
+    const Point       origin         = to_point (points[0]);
+
+    // a - b is exact if the rounding error by the two-sum algorithm is zero.
+    const auto exact_difference = [] (const double a, const double b, double& d) {
+        d                = a - b;
+        const double b_v = d - a;
+        const double a_v = d - b_v;
+        return (a - a_v) + (-b - b_v) == 0.;
+    };
+
+    shape.resize (count_vertices);
+    for (std::size_t i = 0; i < count_vertices; ++i) {
+        const Point p = to_point (points[i]);
+        if (!exact_difference (p.x, origin.x, shape[i].x) ||
+            !exact_difference (p.y, origin.y, shape[i].y)) {
+            for (std::size_t j = 0; j < count_vertices; ++j) shape[j] = to_point (points[j]);
+            return;
+        }
+    }
 }
 
-// Triangulate using ear clipping algorithm
-Triangles
-Polygon::triangulate () const {
-#define __DEBUG_TIKZ__
-#ifdef __DEBUG_TIKZ__
-    open_debug_tikz ("debug.tex");
-#endif
+}  // namespace
+
+//// class BasicPolygonView
+
+template <typename T>
+BasicPolygonView<T>::BasicPolygonView (
+    const std::span<const BasicPoint<T>> points,
+    const WindingMethod                  method
+)
+    : _points{points} {
+    if constexpr (std::is_integral_v<T>) {
+        const auto out_of_range = [] (const T v) {
+            return v <= -geometry::fixed_point_limit || v >= geometry::fixed_point_limit;
+        };
+        for (const BasicPoint<T>& p : points) {
+            if (out_of_range (p.x) || out_of_range (p.y)) {
+                throw std::out_of_range ("Fixed-point coordinate out of range");
+            }
+        }
+    }
+    _winding_dir = determine_winding_direction (points, method);
+}
 
-    // If the winding direction cannot be determined, return empty result.
-    if (_winding_dir == WindingDirection::unknown) return Triangles{};
+// Triangulate and calculate the area without modifying the view
+template <typename T>
+Triangulation
+BasicPolygonView<T>::triangulation (const TriangulationOptions& options) const {
+    Triangulation result;
+    triangulate_into (options, std::pmr::get_default_resource(), result);
+    return result;
+}
 
-    Triangles triangles;
+// Triangulate into `result`, whose triangles are cleared first, with the
+// workspace allocated from the memory resource
+template <typename T>
+void
+BasicPolygonView<T>::triangulate_into (
+    const TriangulationOptions& options,
+    std::pmr::memory_resource*  resource,
+    Triangulation&              result
+) const {
+    if constexpr (!std::is_same_v<T, double>) {
+        if (options.observer) {
+            throw std::invalid_argument ("An observer needs the coordinates in double");
+        }
+    }
 
-    // Create a vector to mark whether a vertex is clipped.
-    std::vector<bool> clipped (_points.size() - 1, false);
+    result.triangles.clear();
+    result.area = 0.;
 
-    std::size_t current_idx = 0;
-    _area                   = 0.0;
+    // If the winding direction cannot be determined, return empty result.
+    if (_winding_dir == WindingDirection::unknown) return;
+
+    TriangulationCache* const cache = options.observer ? nullptr : options.cache;
+    std::pmr::vector<Point>   shape (resource);
+    TriangulationCache::Key   key{};
+    if (cache) {
+        shape_of (_points, shape);
+        key = TriangulationCache::make_key (
+            shape, TriangulationCache::coordinates_code<T>, options.algorithm, options.ear_order
+        );
+        if (cache->find (key, result)) return;
+    }
 
-    while (std::count (clipped.cbegin(), clipped.cend(), false) > 3) {
-        ThreeIndices indices = three_unclipped_vertices (clipped, current_idx);
+    switch (options.algorithm) {
+    case Algorithm::ear_clipping:
+        triangulate_ear_clipping (options, resource, result.triangles);
+        break;
+    case Algorithm::monotone: {
+        const bool ccw = _winding_dir == WindingDirection::ccw;
+        result.triangles =
+            options.pool ? monotone::triangulate (_points, _points.size() - 1, ccw, *options.pool)
+                         : monotone::triangulate (_points, _points.size() - 1, ccw);
+        break;
+    }
+    }
 
-        // Naming convention:
-        //  vp: vertex_previous
-        //  v : current vertex
-        //  vn: vertex_next
-        const std::size_t idx_vp = std::get<0> (indices);
-        const std::size_t idx_v  = std::get<1> (indices);
-        const std::size_t idx_vn = std::get<2> (indices);
+    for (const auto& tri : result.triangles) {
+        result.area += geometry::area (_points[tri[0]], _points[tri[1]], _points[tri[2]]);
+    }
 
-        const Point vp = _points[idx_vp];
-        const Point v  = _points[idx_v];
-        const Point vn = _points[idx_vn];
+    if (cache) cache->insert (key, result);
+}
 
-        std::cout << "[" << current_idx << "] " << idx_vp << ", " << idx_v << ", " << idx_vn
-                  << " : ";
+// Triangulate using ear clipping algorithm
+//
+// Every vertex is classified once at the beginning, and the ears are put in a
+// work queue. Clipping an ear changes only the classification of its two
+// neighbors, so only those are classified again after each clip.
+template <typename T>
+void
+BasicPolygonView<T>::triangulate_ear_clipping (
+    const TriangulationOptions& options,
+    std::pmr::memory_resource*  resource,
+    Triangles&                  triangles
+) const {
+    // Only the views of Point have an observer (see triangulate_into).
+    TriangulationObserver* const observer = options.observer;
+    if constexpr (std::is_same_v<T, double>) {
+        if (observer) observer->on_begin (_points);
+    }
 
-        // Check two conditions whether the three points vp, v, and vn
-        // form a triangle "inside" the polygon.
+    // Ring of the vertices which are not clipped yet.
+    const std::size_t count_vertices = _points.size() - 1;
+    VertexRing        ring (count_vertices, resource);
+
+    // A polygon of n vertices has n - 2 triangles.
+    triangles.reserve (triangles.size() + std::max<std::size_t> (count_vertices, 2) - 2);
+
+    // Only a non-convex vertex can lie inside a triangle (vp, v, vn) whose
+    // vertex v is convex. Register such vertices in a spatial index, so that an
+    // ear test needs to visit only the vertices near the triangle.
+    std::pmr::vector<VertexType> types (count_vertices, resource);
+    std::size_t                  count_nonconvex = 0;
+    for (std::size_t i = 0; i < count_vertices; ++i) {
+        types[i] = vertex_type (ring.prev (i), i, ring.next (i));
+        if (types[i] != VertexType::convex) count_nonconvex++;
+    }
 
-        // 1. Does the line segment (vp, vn) lie inside the polygon?
-        const double q_1    = geometry::angle (vp, v);
-        const double q_2    = geometry::angle (v, vn);
-        double       q_diff = q_2 - q_1;
+    SpatialGrid nonconvex_vertices (geometry::bounding_box (_points), count_nonconvex, resource);
+    for (std::size_t i = 0; i < count_vertices; ++i) {
+        if (types[i] != VertexType::convex) nonconvex_vertices.insert (i, to_point (_points[i]));
+    }
 
-        if (numeric::close_enough (q_diff, std::numbers::pi)) q_diff = -std::numbers::pi;
+    // Ears and degenerate vertices waiting to be clipped. The version of a
+    // vertex increases whenever it is classified again, which invalidates the
+    // entries pushed before.
+    EarQueue                        ears (options.ear_order, resource);
+    std::pmr::vector<std::uint32_t> versions (count_vertices, 0, resource);
+
+    // Push a vertex to the queue if it can be clipped.
+    const auto enqueue_vertex = [&] (const std::size_t idx_v) {
+        const std::size_t idx_vp = ring.prev (idx_v);
+        const std::size_t idx_vn = ring.next (idx_v);
+
+        switch (types[idx_v]) {
+        case VertexType::degenerate:
+            // The line segments (vp, v) and (v, vn) overlap, so v is removed
+            // without making a triangle.
+            ears.push (idx_v, versions[idx_v], std::numeric_limits<double>::infinity());
+            TRIANGULATE_TRACE (trace::EventKind::degenerate_vertex, idx_vp, idx_v, idx_vn);
+            break;
+
+        case VertexType::reflex:
+            // The line segment connecting vp to vn is OUTSIDE of the polygon.
+            TRIANGULATE_TRACE (trace::EventKind::reflex_vertex, idx_vp, idx_v, idx_vn);
+            break;
+
+        case VertexType::convex:
+            // Is the triangle (vp, v, vn) free from the other parts of the polygon?
+            if (has_intersection (nonconvex_vertices, idx_vp, idx_v, idx_vn)) break;
+
+            ears.push (
+                idx_v,
+                versions[idx_v],
+                options.ear_order == EarOrder::quality
+                    ? geometry::smallest_angle_sine (_points[idx_vp], _points[idx_v], _points[idx_vn])
+                    : 0.
+            );
+            TRIANGULATE_TRACE (trace::EventKind::ear_found, idx_vp, idx_v, idx_vn);
+            break;
+        }
+    };
 
-        if (q_diff > std::numbers::pi) q_diff += -2 * std::numbers::pi;
-        if (q_diff < -std::numbers::pi) q_diff += 2 * std::numbers::pi;
+    // Classify a vertex again, and push it to the queue if it can be clipped.
+    const auto classify_vertex = [&] (const std::size_t idx_v) {
+        const VertexType type = vertex_type (ring.prev (idx_v), idx_v, ring.next (idx_v));
 
-        if (numeric::close_enough (q_diff, std::numbers::pi) ||
-            numeric::close_enough (q_diff, -std::numbers::pi)) {
-            // The three points vp, v, and vn form a degenerate feature,
-            // which means the line segments (vp, v) and (v, vn) overlap.
-            std::cout << "x" << std::endl;
-            clipped[idx_v] = true;
-            increase_idx (current_idx);
-            continue;
+        if (types[idx_v] == VertexType::convex && type != VertexType::convex) {
+            nonconvex_vertices.insert (idx_v, to_point (_points[idx_v]));
+        } else if (types[idx_v] != VertexType::convex && type == VertexType::convex) {
+            nonconvex_vertices.remove (idx_v, to_point (_points[idx_v]));
         }
+        types[idx_v] = type;
+        versions[idx_v]++;
 
-        if ((q_diff > 0. && _winding_dir != WindingDirection::ccw) ||
-            (q_diff < 0. && _winding_dir != WindingDirection::cw) ||
-            numeric::close_enough (q_diff, 0.)) {
-            // The line segment connecting vp to vn is OUTSIDE of the polygon.
-            std::cout << "o" << std::endl;
-            increase_idx (current_idx);
-            continue;
+        enqueue_vertex (idx_v);
+    };
+
+    // Classify all vertices. This is repeated only when the queue runs out of
+    // ears before the triangulation completes, which happens only when the
+    // numerical errors hide an ear or the polygon is not simple.
+    std::size_t last_idx = 0;  // Any vertex remaining in the ring
+
+    const auto classify_all_vertices = [&] () {
+        std::size_t idx = last_idx;
+        for (std::size_t i = 0; i < ring.size(); ++i, idx = ring.next (idx)) {
+            classify_vertex (idx);
         }
+    };
+
+    for (std::size_t i = 0; i < count_vertices; ++i) {
+        enqueue_vertex (i);
+    }
 
-        // 2. Is the line segment (vp, vn) free from intersection with other line
-        // segments in the polygon?
-        //
-        // NOTE: This is the most inefficient part of this function.
-        if (has_intersection (clipped, idx_vp, idx_v, idx_vn)) {
-            increase_idx (current_idx);
+    bool reclassified = false;
+    while (ring.size() > 3) {
+        const auto entry = ears.pop();
+        if (!entry.has_value()) {
+            if (reclassified) {
+                // No ear at all
+                TRIANGULATE_TRACE (trace::EventKind::no_ear);
+                break;
+            }
+            classify_all_vertices();
+            reclassified = true;
             continue;
         }
 
-        // Register a triangle
-        register_triangle (triangles, idx_vp, idx_v, idx_vn);
-        _area += geometry::area (_points[idx_vp], _points[idx_v], _points[idx_vn]);
+        // Naming convention:
+        //  vp: vertex_previous
+        //  v : current vertex
+        //  vn: vertex_next
+        const std::size_t idx_v = entry->idx;
+        if (!ring.contains (idx_v) || entry->version != versions[idx_v]) continue;
 
-#ifdef __DEBUG_TIKZ__
-        append_debug_tikz (clipped, triangles);
-#endif
+        const std::size_t idx_vp = ring.prev (idx_v);
+        const std::size_t idx_vn = ring.next (idx_v);
 
-        // Remove the point p and begin with a new head.
-        clipped[idx_v] = true;
-        std::cout << "*" << std::endl;
-    }
+        if (types[idx_v] == VertexType::convex) {
+            // Register a triangle
+            register_triangle (triangles, idx_vp, idx_v, idx_vn);
+            TRIANGULATE_TRACE (trace::EventKind::ear_clipped, idx_vp, idx_v, idx_vn);
 
-    // Add the remaining triangle
-    ThreeIndices indices = three_unclipped_vertices (clipped, current_idx);
+            if constexpr (std::is_same_v<T, double>) {
+                if (observer) observer->on_ear_clipped (_points, ring, triangles);
+            }
+        }
 
-    const std::size_t idx_vp = std::get<0> (indices);
-    const std::size_t idx_v  = std::get<1> (indices);
-    const std::size_t idx_vn = std::get<2> (indices);
+        // Remove the point v, and classify its neighbors again.
+        if (types[idx_v] != VertexType::convex) {
+            nonconvex_vertices.remove (idx_v, to_point (_points[idx_v]));
+        }
+        ring.remove (idx_v);
 
-    std::cout << idx_vp << ", " << idx_v << ", " << idx_vn << " : ";
-    register_triangle (triangles, idx_vp, idx_v, idx_vn);
-    _area += geometry::area (_points[idx_vp], _points[idx_v], _points[idx_vn]);
-    std::cout << "*" << std::endl;
+        classify_vertex (idx_vp);
+        classify_vertex (idx_vn);
 
-#ifdef __DEBUG_TIKZ__
-    append_debug_tikz (clipped, triangles);
-    close_debug_tikz();
-#endif
+        last_idx     = idx_vp;
+        reclassified = false;
+    }
 
-    return triangles;
-}
+    if (ring.size() == 3) {
+        // Add the remaining triangle
+        const std::size_t idx_vp = last_idx;
+        const std::size_t idx_v  = ring.next (idx_vp);
+        const std::size_t idx_vn = ring.next (idx_v);
 
-double
-Polygon::area () const {
-    return _area;
-}
+        register_triangle (triangles, idx_vp, idx_v, idx_vn);
+        TRIANGULATE_TRACE (trace::EventKind::ear_clipped, idx_vp, idx_v, idx_vn);
+    }
 
-void
-Polygon::increase_idx (std::size_t& idx) const {
-    idx = (idx + 1) % (_points.size() - 1);
+    if constexpr (std::is_same_v<T, double>) {
+        if (observer) observer->on_end (_points, ring, triangles);
+    }
 }
 
 // Determine the winding direction of the polygon.
 // Assume that the points form a closed polygon, i.e., the first and last
 // elements coincide.
-void
-Polygon::determine_winding_direction (const Points& points) const {
-    // determine_winding_dir_angular_displacement (points);
-    constexpr int count_random_rays = 32;
-    for (std::size_t i : std::views::iota (0, static_cast<int> (points.size() - 1))) {
-        const Point  p     = geometry::midpoint (points[i], points[i + 1]);
-        const double angle = geometry::angle (points[i], points[i + 1]);
-
-        random_point_around_semicircle random_point{angle};
-        int                            count_interior_ray = 0;
-
-        for ([[maybe_unused]] auto _ : std::views::iota (0, count_random_rays)) {
-            const Point q           = random_point() + p;
-            int count_intersections = 1;  // Includes point p which intersects current segment
-            for (std::size_t j = 0; j < points.size() - 1; ++j) {
-                if (j == i) continue;
-                if (geometry::does_intersect (
-                        p, q, points[j], points[j + 1], geometry::LineType::ray, false
-                    ))
-                    count_intersections++;
-            }
-            if (count_intersections % 2 == 0) count_interior_ray++;
+template <typename T>
+WindingDirection
+BasicPolygonView<T>::determine_winding_direction (
+    const std::span<const BasicPoint<T>> points,
+    const WindingMethod                  method
+) {
+    if (method == WindingMethod::ray_casting) {
+        if constexpr (std::is_same_v<T, double>) {
+            return winding_direction_by_ray_casting (points);
+        } else {
+            // The rays are cast in double.
+            Points converted (points.size());
+            std::ranges::transform (points, converted.begin(), to_point<T>);
+            return winding_direction_by_ray_casting (converted);
         }
-        constexpr double threshold = 0.2;
-        if (threshold * count_random_rays < count_interior_ray &&
-            count_interior_ray < (1. - threshold) * count_random_rays)
-            continue;
-
-        if (count_interior_ray > (1. - threshold) * count_random_rays) {
-            _winding_dir = WindingDirection::ccw;
-        } else if (count_interior_ray < threshold * count_random_rays) {
-            _winding_dir = WindingDirection::cw;
-        }
-        return;
     }
 
-    _winding_dir = WindingDirection::unknown;
+    const double area = geometry::signed_area (points);
+    if (area > 0.) return WindingDirection::ccw;
+    if (area < 0.) return WindingDirection::cw;
+    return WindingDirection::unknown;
 }
 
+template <typename T>
 void
-Polygon::register_triangle (
+BasicPolygonView<T>::register_triangle (
     Triangles&        triangles,
     const std::size_t a,
     const std::size_t b,
@@ -205,94 +405,75 @@ Polygon::register_triangle (
     }
 }
 
-// Find the index to a vertex which is not clipped, from offset.
-std::optional<std::size_t>
-Polygon::index_unclipped_vertex (const std::vector<bool>& clipped, const std::size_t offset) const {
-    if (offset > clipped.size() - 1) return std::nullopt;
-
-    auto it = std::find (clipped.cbegin() + offset, clipped.cend(), false);
-    if (it == clipped.cend()) {  // Not found from offset to the end
-        if (offset != 0) {
-            // Find from begin to offset
-            it = std::find (clipped.cbegin(), clipped.cbegin() + offset, false);
-            if (it == clipped.cbegin() + offset)  // Still not found
-                return std::nullopt;
-            else return std::distance (clipped.cbegin(), it);
-        } else  // Not found from begin to end
-            return std::nullopt;
-    }
-    return std::distance (clipped.cbegin(), it);
-}
-
-// Find three consecutive vertices which is not clipped, beginning from offset.
-// If idx is at either of the end of the vector, this function finds neighbors
-// regarding the vector as a circular buffer.
-//
-// NOTE: when this function returns (0, 0, 0), it means it failed to find the
-// vertices.
-Polygon::ThreeIndices
-Polygon::three_unclipped_vertices (
-    const std::vector<bool>& clipped,
-    const std::size_t        offset
+// Classify the vertex v by the turn from the edge (vp, v) to (v, vn).
+template <typename T>
+typename BasicPolygonView<T>::VertexType
+BasicPolygonView<T>::vertex_type (
+    const std::size_t idx_vp,
+    const std::size_t idx_v,
+    const std::size_t idx_vn
 ) const {
-    // First, check whether there are three unclipped vertices
-    if (std::count (clipped.cbegin(), clipped.cend(), false) < 3)
-        return std::make_tuple (0, 0, 0);  // This indicates NOT found
-
-    // Searching from offset
-    std::size_t idx1, idx2, idx3;
-
-    auto opt_idx1 = index_unclipped_vertex (clipped, offset);
-    if (opt_idx1.has_value()) idx1 = opt_idx1.value();
-    else idx1 = 0;
-
-    auto opt_idx2 = index_unclipped_vertex (clipped, idx1 + 1);
-    if (opt_idx2.has_value()) idx2 = opt_idx2.value();
-    else idx2 = 0;
+    const BasicPoint<T>& vp = _points[idx_vp];
+    const BasicPoint<T>& v  = _points[idx_v];
+    const BasicPoint<T>& vn = _points[idx_vn];
+
+    if (vp == v || v == vn) return VertexType::degenerate;
+
+    const double turn = geometry::orientation (vp, v, vn);
+    if (turn == 0.) {
+        // The edges are collinear: either straight, or the second one goes
+        // back along the first one.
+        const bool backward = numeric::sign (v.x - vp.x) * numeric::sign (vn.x - v.x) < 0 ||
+                              numeric::sign (v.y - vp.y) * numeric::sign (vn.y - v.y) < 0;
+        return backward ? VertexType::degenerate : VertexType::reflex;
+    }
 
-    auto opt_idx3 = index_unclipped_vertex (clipped, idx2 + 1);
-    if (opt_idx3.has_value()) idx3 = opt_idx3.value();
-    else idx3 = 0;
+    if ((turn > 0. && _winding_dir != WindingDirection::ccw) ||
+        (turn < 0. && _winding_dir != WindingDirection::cw))
+        return VertexType::reflex;
 
-    return std::make_tuple (idx1, idx2, idx3);
+    return VertexType::convex;
 }
 
+// Check whether the triangle (vp, v, vn) contains any of the non-convex
+// vertices remaining in the polygon.
+//
+// For a convex vertex v, this is equivalent to checking whether the line
+// segment (vp, vn) intersects any edge of the polygon: an edge can enter the
+// triangle only through the line segment (vp, vn), and then it ends at a
+// non-convex vertex inside the triangle.
+template <typename T>
 bool
-Polygon::has_intersection (
-    const std::vector<bool>& clipped,
-    const std::size_t        idx_vp,
-    const std::size_t        idx_v,
-    const std::size_t        idx_vn
+BasicPolygonView<T>::has_intersection (
+    const SpatialGrid& nonconvex_vertices,
+    const std::size_t  idx_vp,
+    const std::size_t  idx_v,
+    const std::size_t  idx_vn
 ) const {
-    for (std::size_t i = 0; i < _points.size(); ++i) {
-        const auto opt_i = index_unclipped_vertex (clipped, i);
-        if (!opt_i.has_value()) break;
-
-        const std::size_t idx_seg_i = opt_i.value();
-
-        const auto opt_j = index_unclipped_vertex (clipped, idx_seg_i + 1);
-        if (!opt_j.has_value()) break;
+    const BasicPoint<T>& vp = _points[idx_vp];
+    const BasicPoint<T>& v  = _points[idx_v];
+    const BasicPoint<T>& vn = _points[idx_vn];
 
-        const std::size_t idx_seg_j = opt_j.value();
+    return nonconvex_vertices.any_of (
+        geometry::bounding_box (vp, v, vn),
+        [&] (const std::size_t idx) {
+            if (idx == idx_vp || idx == idx_v || idx == idx_vn) return false;
 
-        // Exclude line segments which coincide with the current vertices.
-        if ((idx_seg_j == idx_vp) || (idx_seg_i == idx_vp && idx_seg_j == idx_v) ||
-            (idx_seg_i == idx_v && idx_seg_j == idx_vn) || idx_seg_i == idx_vn)
-            continue;
+            // A vertex touching the triangle at its corner does not block it.
+            const BasicPoint<T>& p = _points[idx];
+            if (p == vp || p == vn) return false;
 
-        const Point r = _points[idx_seg_i];
-        const Point s = _points[idx_seg_j];
+            if (!geometry::is_inside_triangle (vp, v, vn, p)) return false;
 
-        if (geometry::does_intersect (_points[idx_vp], _points[idx_vn], r, s)) {
-            std::cout << "+ " << idx_v << " - " << idx_seg_i << ", " << idx_seg_j << std::endl;
+            TRIANGULATE_TRACE (trace::EventKind::ear_blocked, idx_vp, idx_v, idx_vn, idx);
             return true;
         }
-    }
-    return false;
+    );
 }
 
+template <typename T>
 std::string
-Polygon::winding_direction () const {
+BasicPolygonView<T>::winding_direction () const {
     switch (_winding_dir) {
     case WindingDirection::ccw: return "ccw"; break;
     case WindingDirection::cw: return "cw"; break;
@@ -300,32 +481,54 @@ Polygon::winding_direction () const {
     }
 }
 
-void
-Polygon::open_debug_tikz (const std::string& filename) const {
-    _debug_tex_tikz_file = std::ofstream{filename};
+template class BasicPolygonView<float>;
+template class BasicPolygonView<double>;
+template class BasicPolygonView<std::int64_t>;
 
-    if (!_debug_tex_tikz_file.is_open()) {
-        throw std::runtime_error ("Failed to open file: " + filename);
-    }
-    _debug_tex_tikz_file << "\\input tikz.tex\n"
-                         << "\\baselineskip=12pt\n"
-                         << "\\hsize=6.3truein\n"
-                         << "\\vsize=8.7truein\n"
-                         << "\\nopagenumbers\n";
+//// class Polygon
+
+// The points are moved, and the winding direction is determined once.
+Polygon::Polygon (Points&& pts, const WindingMethod method)
+    : _points{std::move (pts)}
+    , _winding_dir{PolygonView::determine_winding_direction (_points, method)} {}
+
+// Triangulate using the algorithm chosen in the options
+Triangles
+Polygon::triangulate (const TriangulationOptions& options) const {
+    return std::move (triangulation (options).triangles);
 }
 
-void
-Polygon::close_debug_tikz () const {
-    _debug_tex_tikz_file << "\\vfill\\eject\n" << "\\bye\n";
-    _debug_tex_tikz_file.close();
+// Triangulate and calculate the area without modifying the polygon
+Triangulation
+Polygon::triangulation (const TriangulationOptions& options) const {
+    return view().triangulation (options);
 }
 
-void
-Polygon::append_debug_tikz (const std::vector<bool>& flags, const Triangles& triangles) const {
-    _debug_tex_tikz_file << "Triangulation:\n"
-                         << "\\vskip12pt\n";
+const PolygonMetrics&
+Polygon::metrics () const {
+    std::call_once (_metrics->once, [this] {
+        _metrics->metrics = geometry::polygon_metrics (_points);
+    });
+    return _metrics->metrics;
+}
 
-    _debug_tex_tikz_file << fileio::string_tikz_polygon (_points, flags, triangles, 0.25);
+double
+Polygon::area () const {
+    return std::abs (metrics().signed_area);
+}
 
-    _debug_tex_tikz_file << "\\vfill\\eject\n";
+// The area of the triangles and that by the shoelace formula are rounded
+// differently, by at most a few units in the last place of the terms, whose
+// magnitude is bounded by the area of the bounding box.
+bool
+Polygon::covers (const Triangulation& triangulation) const {
+    const BoundingBox& box      = metrics().box;
+    const double       box_area = (box.upper.x - box.lower.x) * (box.upper.y - box.lower.y);
+    const double tolerance = 8. * static_cast<double> (size()) * predicates::epsilon * box_area;
+    return std::abs (triangulation.area - area()) <= tolerance;
+}
+
+std::string
+Polygon::winding_direction () const {
+    return view().winding_direction();
 }
@@ -7,47 +7,162 @@
 #ifndef __POLYGON_H__
 #define __POLYGON_H__
 
-#include <fstream>
-#include <optional>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
 #include <string>
-#include <tuple>
 #include <vector>
 
+#include "core/ear_queue.h"
+#include "core/metrics.h"
+#include "core/observer.h"
 #include "core/primitive.h"
+#include "core/spatial_grid.h"
+#include "core/thread_pool.h"
+#include "core/vertex_ring.h"
 
-//// class Polygon
+class TriangulationCache;
 
-class Polygon {
-    using ThreeIndices = std::tuple<std::size_t, std::size_t, std::size_t>;
+//// Enum: Algorithm
+
+// .ear_clipping: clip the ears one by one, in O(n^2) time in the worst case
+// .monotone: decompose the polygon into y-monotone pieces with a sweep line,
+//   and triangulate each of them, in O(n log n) time
+enum class Algorithm { ear_clipping, monotone };
+
+//// Struct: TriangulationOptions
+
+struct TriangulationOptions {
+    // Algorithm to triangulate
+    Algorithm algorithm = Algorithm::ear_clipping;
+
+    // Order to clip the ears (Algorithm::ear_clipping only)
+    EarOrder ear_order = EarOrder::fifo;
+
+    // Threads to triangulate the monotone pieces of the polygon concurrently,
+    // if any (Algorithm::monotone only, not owned)
+    ThreadPool* pool = nullptr;
+
+    // Observer notified of every step, if any (not owned)
+    // NOTE: only Algorithm::ear_clipping reports its steps.
+    TriangulationObserver* observer = nullptr;
+
+    // Cache of the polygons triangulated before, if any (not owned)
+    // NOTE: with an observer, the cache is not used, so that every step is
+    // reported.
+    TriangulationCache* cache = nullptr;
+};
+
+//// Struct: Triangulation
+
+struct Triangulation {
+    Triangles triangles;
+    double    area = 0.;
+};
+
+//// Enum: WindingDirection
+
+// .ccw: the points in the polygon winds counter-clockwise direction
+// .cw: the points in the polygon winds clockwise direction
+enum class WindingDirection { ccw, cw, unknown };
+
+//// Enum: WindingMethod
 
+// Method to determine the winding direction
+// .signed_area: sign of the area by the shoelace formula, in O(n) time
+// .ray_casting: count the crossings of random rays cast from every edge,
+//   in O(n^2) time. The rays are the same from run to run.
+enum class WindingMethod { signed_area, ray_casting };
+
+//// class BasicPolygonView
+
+// Polygon over points owned by the caller, e.g., a mapped file, a shared memory
+// buffer or an array of another library. The points are neither copied nor
+// modified, and they must outlive the view.
+//
+// The points form a closed polygon, i.e., the first and last elements
+// coincide, as those of Polygon do.
+//
+// The view is instantiated for the coordinates of PointF, Point and PointI.
+// The coordinates of PointI should be less than geometry::fixed_point_limit in
+// magnitude (std::out_of_range), so that its predicates are exact. The
+// observers are notified only for Point (std::invalid_argument otherwise).
+template <typename T> class BasicPolygonView {
   public:
-    // .ccw: the points in the polygon winds counter-clockwise direction
-    // .cw: the points in the polygon winds clockwise direction
-    enum class WindingDirection { ccw, cw, unknown };
+    using WindingDirection = ::WindingDirection;
+    using WindingMethod    = ::WindingMethod;
 
-    Polygon (Points&& pts);
+    explicit BasicPolygonView (
+        const std::span<const BasicPoint<T>> points,
+        const WindingMethod                  method = WindingMethod::signed_area
+    );
 
-    ~Polygon ();
+    // Triangulate using the algorithm chosen in the options, and return the
+    // area together. This does not modify the view, so several threads may call
+    // it on the same view at the same time.
+    //
+    // NOTE: if the polygon is not simple, the result may be incomplete.
+    Triangulation
+    triangulation (const TriangulationOptions& options = {}) const;
 
-    // Triangulate using ear clipping algorithm
-    Triangles
-    triangulate () const;
+    // Points of the polygon, including the closing point
+    std::span<const BasicPoint<T>>
+    points () const {
+        return _points;
+    }
 
-    double
-    area () const;
+    // Number of vertices, not counting the closing point
+    std::size_t
+    size () const {
+        return _points.size() - 1;
+    }
 
     std::string
     winding_direction () const;
 
   private:
-    void
-    increase_idx (std::size_t& idx) const;
+    template <typename> friend class BasicPolygonView;
+    friend class Polygon;
+    friend class Triangulator;
+
+    // View of the points whose winding direction is already known
+    BasicPolygonView (const std::span<const BasicPoint<T>> points, const WindingDirection direction)
+        : _points{points}
+        , _winding_dir{direction} {}
+
+    // .convex: the interior angle at the vertex is less than 180 degrees
+    // .reflex: the interior angle is 180 degrees or more
+    // .degenerate: the two edges at the vertex overlap (360 degrees), or one
+    //              of them has zero length
+    enum class VertexType { convex, reflex, degenerate };
 
     // Determine the winding direction of the polygon.
     // Assume that the points form a closed polygon, i.e., the first and last
     // elements coincide.
+    static WindingDirection
+    determine_winding_direction (
+        const std::span<const BasicPoint<T>> points,
+        const WindingMethod                  method
+    );
+
+    // Triangulate as triangulation() does, into `result`, whose triangles are
+    // cleared first. The workspace is allocated from the memory resource.
     void
-    determine_winding_direction (const Points& points) const;
+    triangulate_into (
+        const TriangulationOptions& options,
+        std::pmr::memory_resource*  resource,
+        Triangulation&              result
+    ) const;
+
+    // Triangulate using ear clipping algorithm, and append the triangles.
+    void
+    triangulate_ear_clipping (
+        const TriangulationOptions& options,
+        std::pmr::memory_resource*  resource,
+        Triangles&                  triangles
+    ) const;
 
     void
     register_triangle (
@@ -57,41 +172,101 @@ class Polygon {
         const std::size_t c
     ) const;
 
-    // Find the index to a vertex which is not clipped, from offset.
-    std::optional<std::size_t>
-    index_unclipped_vertex (const std::vector<bool>& clipped, const std::size_t offset = 0) const;
-
-    // Find three consecutive vertices which is not clipped, beginning from
-    // offset. If idx is at either of the end of the vector, this function finds
-    // neighbors regarding the vector as a circular buffer.
-    //
-    // NOTE: when this function returns (0, 0, 0), it means it failed to find the
-    // vertices.
-    ThreeIndices
-    three_unclipped_vertices (const std::vector<bool>& clipped, const std::size_t offset = 0) const;
+    // Classify the vertex v by the turn from the edge (vp, v) to (v, vn).
+    VertexType
+    vertex_type (const std::size_t idx_vp, const std::size_t idx_v, const std::size_t idx_vn)
+        const;
 
+    // Check whether the triangle (vp, v, vn) contains any of the non-convex
+    // vertices remaining in the polygon.
     bool
     has_intersection (
-        const std::vector<bool>& clipped,
-        const std::size_t        idx_vp,
-        const std::size_t        idx_v,
-        const std::size_t        idx_vn
+        const SpatialGrid& nonconvex_vertices,
+        const std::size_t  idx_vp,
+        const std::size_t  idx_v,
+        const std::size_t  idx_vn
     ) const;
 
-    void
-    open_debug_tikz (const std::string& filename) const;
+  private:
+    std::span<const BasicPoint<T>> _points;
+    WindingDirection               _winding_dir;
+};
 
-    void
-    close_debug_tikz () const;
+using PolygonView  = BasicPolygonView<double>;
+using PolygonViewF = BasicPolygonView<float>;
+using PolygonViewI = BasicPolygonView<std::int64_t>;
 
-    void
-    append_debug_tikz (const std::vector<bool>& flags, const Triangles& triangles) const;
+//// class Polygon
+
+// Polygon owning its points. The triangulation is that of view().
+class Polygon {
+  public:
+    using WindingDirection = ::WindingDirection;
+    using WindingMethod    = ::WindingMethod;
+
+    // The points are moved into the polygon, not copied.
+    Polygon (Points&& pts, const WindingMethod method = WindingMethod::signed_area);
+
+    // Triangulate using the algorithm chosen in the options.
+    //
+    // NOTE: if the polygon is not simple, the result may be incomplete, which
+    // covers() detects.
+    Triangles
+    triangulate (const TriangulationOptions& options = {}) const;
+
+    // Triangulate as triangulate() does, and return the area of the triangles
+    // together. This does not modify the polygon, so several threads may call
+    // it on the same polygon at the same time.
+    Triangulation
+    triangulation (const TriangulationOptions& options = {}) const;
+
+    // Measures of the polygon, computed from the vertices in O(n) time on the
+    // first call and kept (see geometry::polygon_metrics). Several threads may
+    // call it on the same polygon at the same time; only one computes them.
+    const PolygonMetrics&
+    metrics () const;
+
+    // Area of the polygon by the shoelace formula, without triangulating it
+    double
+    area () const;
+
+    // Check whether the triangles cover the polygon, i.e., their area is that
+    // of the polygon up to the rounding error. Fails if the triangulation of
+    // a polygon which is not simple is incomplete.
+    bool
+    covers (const Triangulation& triangulation) const;
+
+    // View of the points, valid as long as the polygon
+    PolygonView
+    view () const {
+        return PolygonView{_points, _winding_dir};
+    }
+
+    const Points&
+    points () const {
+        return _points;
+    }
+
+    // Number of vertices, not counting the closing point
+    std::size_t
+    size () const {
+        return _points.size() - 1;
+    }
+
+    std::string
+    winding_direction () const;
 
   private:
-    Points                   _points;
-    mutable double           _area;
-    mutable WindingDirection _winding_dir;
-    mutable std::ofstream    _debug_tex_tikz_file;
+    // Metrics filled once by the first call of metrics(). The points do not
+    // change, so the copies of a polygon share them.
+    struct LazyMetrics {
+        std::once_flag once;
+        PolygonMetrics metrics;
+    };
+
+    Points                       _points;
+    WindingDirection             _winding_dir;
+    std::shared_ptr<LazyMetrics> _metrics = std::make_shared<LazyMetrics>();
 };
 
 #endif
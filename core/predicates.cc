@@ -0,0 +1,224 @@
+#include "core/predicates.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+//// NAMESPACE: predicates
+namespace predicates {
+
+namespace {
+
+// Error bound of incircle in floating point, in the same sense as
+// orient2d_error_bound
+constexpr double incircle_error_bound = (10. + 96. * epsilon) * epsilon;
+
+//// Floating-point expansions
+//
+// An expansion represents a number exactly as the sum of doubles whose
+// nonzero components do not overlap, in increasing order of magnitude. The
+// largest component has the sign of the whole sum.
+//
+// The components are kept in a fixed array on the stack, since the exact
+// evaluations run for every collinear turn, which is common in rectilinear
+// data. The capacity N bounds the number of components, and every operation
+// returns an expansion whose capacity bounds that of its result, e.g., 16 for
+// orient2d and 1536 for incircle.
+
+template <std::size_t N> struct Expansion {
+    std::array<double, N> components;  // Only the first `size` are valid
+    std::size_t           size = 0;
+
+    double
+    operator[] (const std::size_t i) const {
+        return components[i];
+    }
+};
+
+// a + b = x + y exactly, where x = fl(a + b)
+void
+two_sum (const double a, const double b, double& x, double& y) {
+    x                = a + b;
+    const double b_v = x - a;
+    const double a_v = x - b_v;
+    y                = (a - a_v) + (b - b_v);
+}
+
+// a * b = x + y exactly, where x = fl(a * b)
+void
+two_product (const double a, const double b, double& x, double& y) {
+    x = a * b;
+    y = std::fma (a, b, -x);
+}
+
+// The exact difference a - b as an expansion
+Expansion<2>
+difference (const double a, const double b) {
+    Expansion<2> h;
+    two_sum (a, -b, h.components[1], h.components[0]);
+    h.size = 2;
+    return h;
+}
+
+// h += b in place, eliminating zero components. The capacity of h should be
+// larger than its size. Every component is read before it is overwritten,
+// since at most one is written for every one read.
+template <std::size_t N>
+void
+grow (Expansion<N>& h, const double b) {
+    std::size_t count = 0;
+
+    double q = b;
+    for (std::size_t i = 0; i < h.size; ++i) {
+        double sum, error;
+        two_sum (q, h.components[i], sum, error);
+        if (error != 0.) h.components[count++] = error;
+        q = sum;
+    }
+    if (q != 0. || count == 0) h.components[count++] = q;
+    h.size = count;
+}
+
+// e + f
+template <std::size_t N, std::size_t M>
+Expansion<N + M>
+sum (const Expansion<N>& e, const Expansion<M>& f) {
+    Expansion<N + M> h;
+    std::copy_n (e.components.begin(), e.size, h.components.begin());
+    h.size = e.size;
+    for (std::size_t i = 0; i < f.size; ++i) grow (h, f[i]);
+    return h;
+}
+
+// e * b, eliminating zero components. The first component adds at most one,
+// since q is still zero, so the result has at most 2N.
+template <std::size_t N>
+Expansion<2 * N>
+scale (const Expansion<N>& e, const double b) {
+    Expansion<2 * N> h;
+
+    double q = 0.;
+    for (std::size_t i = 0; i < e.size; ++i) {
+        double product, product_error, total, error;
+        two_product (e[i], b, product, product_error);
+        two_sum (q, product_error, total, error);
+        if (error != 0.) h.components[h.size++] = error;
+        two_sum (product, total, q, error);
+        if (error != 0.) h.components[h.size++] = error;
+    }
+    if (q != 0. || h.size == 0) h.components[h.size++] = q;
+    return h;
+}
+
+// e * f, the sum of e * f_i over the components of f
+template <std::size_t N, std::size_t M>
+Expansion<2 * N * M>
+product (const Expansion<N>& e, const Expansion<M>& f) {
+    Expansion<2 * N * M> h;
+    for (std::size_t i = 0; i < f.size; ++i) {
+        const Expansion<2 * N> scaled = scale (e, f[i]);
+        for (std::size_t j = 0; j < scaled.size; ++j) grow (h, scaled[j]);
+    }
+    return h;
+}
+
+template <std::size_t N>
+Expansion<N>
+negate (Expansion<N> e) {
+    for (std::size_t i = 0; i < e.size; ++i) e.components[i] = -e.components[i];
+    return e;
+}
+
+// Approximate value of the expansion, i.e., its largest component, which has
+// the sign of the whole sum
+template <std::size_t N>
+double
+estimate (const Expansion<N>& e) {
+    return e[e.size - 1];
+}
+
+//// Exact evaluations
+
+// p.x * q.y - p.y * q.x
+Expansion<16>
+cross (
+    const Expansion<2>& px,
+    const Expansion<2>& py,
+    const Expansion<2>& qx,
+    const Expansion<2>& qy
+) {
+    return sum (product (px, qy), negate (product (py, qx)));
+}
+
+// p.x^2 + p.y^2
+Expansion<16>
+lift (const Expansion<2>& px, const Expansion<2>& py) {
+    return sum (product (px, px), product (py, py));
+}
+
+double
+incircle_exact (const Point& a, const Point& b, const Point& c, const Point& d) {
+    const Expansion<2> adx = difference (a.x, d.x);
+    const Expansion<2> ady = difference (a.y, d.y);
+    const Expansion<2> bdx = difference (b.x, d.x);
+    const Expansion<2> bdy = difference (b.y, d.y);
+    const Expansion<2> cdx = difference (c.x, d.x);
+    const Expansion<2> cdy = difference (c.y, d.y);
+
+    const Expansion<512> a_term = product (lift (adx, ady), cross (bdx, bdy, cdx, cdy));
+    const Expansion<512> b_term = product (lift (bdx, bdy), cross (cdx, cdy, adx, ady));
+    const Expansion<512> c_term = product (lift (cdx, cdy), cross (adx, ady, bdx, bdy));
+
+    return estimate (sum (sum (a_term, b_term), c_term));
+}
+
+}  // namespace
+
+// orient2d in exact arithmetic, without the floating-point filter
+double
+orient2d_exact (const Point& a, const Point& b, const Point& c) {
+    const Expansion<2> acx = difference (a.x, c.x);
+    const Expansion<2> bcy = difference (b.y, c.y);
+    const Expansion<2> acy = difference (a.y, c.y);
+    const Expansion<2> bcx = difference (b.x, c.x);
+
+    return estimate (cross (acx, acy, bcx, bcy));
+}
+
+// Positive if the point d lies inside the circle through a, b and c, negative
+// if outside, and zero if on the circle.
+double
+incircle (const Point& a, const Point& b, const Point& c, const Point& d) {
+    const double adx = a.x - d.x;
+    const double bdx = b.x - d.x;
+    const double cdx = c.x - d.x;
+    const double ady = a.y - d.y;
+    const double bdy = b.y - d.y;
+    const double cdy = c.y - d.y;
+
+    const double bdxcdy = bdx * cdy;
+    const double cdxbdy = cdx * bdy;
+    const double alift  = adx * adx + ady * ady;
+
+    const double cdxady = cdx * ady;
+    const double adxcdy = adx * cdy;
+    const double blift  = bdx * bdx + bdy * bdy;
+
+    const double adxbdy = adx * bdy;
+    const double bdxady = bdx * ady;
+    const double clift  = cdx * cdx + cdy * cdy;
+
+    const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+                       clift * (adxbdy - bdxady);
+
+    const double permanent = (std::abs (bdxcdy) + std::abs (cdxbdy)) * alift +
+                             (std::abs (cdxady) + std::abs (adxcdy)) * blift +
+                             (std::abs (adxbdy) + std::abs (bdxady)) * clift;
+
+    if (std::abs (det) >= incircle_error_bound * permanent) return det;
+
+    return incircle_exact (a, b, c, d);
+}
+
+}  // namespace predicates
@@ -0,0 +1,65 @@
+//
+// predicates.h
+//
+// Robust geometric predicates
+//
+// The predicates are evaluated in floating-point arithmetic first, together
+// with a bound of the rounding error (Shewchuk, "Adaptive Precision
+// Floating-Point Arithmetic and Fast Robust Geometric Predicates", 1997).
+// Only if the result is within the bound, it is evaluated again in exact
+// arithmetic with floating-point expansions. So the sign of the result is
+// always correct, and the common case costs a few multiplications.
+//
+
+#ifndef __PREDICATES_H__
+#define __PREDICATES_H__
+
+#include <cmath>
+#include <limits>
+
+#include "core/primitive.h"
+
+//// NAMESPACE: predicates
+namespace predicates {
+
+// Half of the machine epsilon, i.e., the relative rounding error
+inline constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2.;
+
+// If |det| >= orient2d_error_bound * (|detleft| + |detright|), where
+//   detleft  = (a.x - c.x) * (b.y - c.y),
+//   detright = (a.y - c.y) * (b.x - c.x),
+// and det = detleft - detright, all in floating point, the sign of det is
+// correct. Useful to evaluate orient2d in bulk, e.g., with SIMD instructions.
+inline constexpr double orient2d_error_bound = (3. + 16. * epsilon) * epsilon;
+
+// orient2d in exact arithmetic, without the floating-point filter
+double
+orient2d_exact (const Point& a, const Point& b, const Point& c);
+
+// Positive if the points a, b and c wind counter-clockwise, negative if they
+// wind clockwise, and zero if they are collinear. The magnitude approximates
+// twice the area of the triangle (a, b, c).
+//
+// Defined here, since the filter is only a few operations, and it is called
+// in the inner loops of the triangulations.
+inline double
+orient2d (const Point& a, const Point& b, const Point& c) {
+    const double detleft  = (a.x - c.x) * (b.y - c.y);
+    const double detright = (a.y - c.y) * (b.x - c.x);
+    const double det      = detleft - detright;
+
+    if (std::abs (det) >= orient2d_error_bound * (std::abs (detleft) + std::abs (detright)))
+        return det;
+
+    return orient2d_exact (a, b, c);
+}
+
+// Positive if the point d lies inside the circle through a, b and c, negative
+// if outside, and zero if on the circle. The points a, b and c should wind
+// counter-clockwise; otherwise the sign is reversed.
+double
+incircle (const Point& a, const Point& b, const Point& c, const Point& d);
+
+}  // namespace predicates
+
+#endif
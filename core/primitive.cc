@@ -2,17 +2,16 @@
 
 #include <cmath>
 
-Point
-operator+ (const Point& a, const Point& b) {
-    return Point{a.x + b.x, a.y + b.y};
-}
-
-bool
-operator== (const Point& a, const Point& b) {
-    return a.x == b.x && a.y == b.y;
-}
-
 bool
 close_enough (const Point& a, const Point& b, const double threshold) {
     return std::abs (a.x - b.x) < threshold && std::abs (a.y - b.y) < threshold;
 }
+
+PointArrays::PointArrays (const std::span<const Point> points) {
+    x.reserve (points.size());
+    y.reserve (points.size());
+    for (const Point& p : points) {
+        x.push_back (p.x);
+        y.push_back (p.y);
+    }
+}
@@ -2,25 +2,52 @@
 #define __PRIMITIVE_H__
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 //// Point struct and related functions
-struct Point {
-    double x = 0.;
-    double y = 0.;
+
+// Point whose coordinates are of type T. The triangulation supports
+// .double: the default, Point
+// .float: half the memory of double, PointF
+// .std::int64_t: fixed-point coordinates snapped to integers, whose predicates
+//   are exact without any tolerance, PointI (see geometry::fixed_point_limit)
+template <typename T> struct BasicPoint {
+    T x = 0;
+    T y = 0;
 
     void
-    operator+= (const Point& p) {
+    operator+= (const BasicPoint& p) {
         this->x += p.x;
         this->y += p.y;
     }
 };
 
-Point
-operator+ (const Point& a, const Point& b);
+using Point  = BasicPoint<double>;
+using PointF = BasicPoint<float>;
+using PointI = BasicPoint<std::int64_t>;
 
+template <typename T>
+BasicPoint<T>
+operator+ (const BasicPoint<T>& a, const BasicPoint<T>& b) {
+    return BasicPoint<T>{a.x + b.x, a.y + b.y};
+}
+
+template <typename T>
 bool
-operator== (const Point& a, const Point& b);
+operator== (const BasicPoint<T>& a, const BasicPoint<T>& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+// Point of double coordinates, which are exact for float, and for integers up
+// to 2^53
+template <typename T>
+Point
+to_point (const BasicPoint<T>& p) {
+    return Point{static_cast<double> (p.x), static_cast<double> (p.y)};
+}
 
 bool
 close_enough (const Point& a, const Point& b, const double threshold = 1e-12);
@@ -31,9 +58,56 @@ struct Polar {
     double angle;  // In radians
 };
 
+//// Struct: BoundingBox (axis-aligned)
+struct BoundingBox {
+    Point lower;
+    Point upper;
+};
+
 //// Type Aliases
 using TriangleSpec = std::array<std::size_t, 3>;
 using Triangles    = std::vector<TriangleSpec>;
 using Points       = std::vector<Point>;
 
+//// Struct: PointArrays (structure of arrays)
+
+// Coordinates of points in separate arrays, so that the same coordinate of
+// consecutive points can be loaded into a vector register at once.
+struct PointArrays {
+    std::vector<double> x;
+    std::vector<double> y;
+
+    PointArrays () = default;
+
+    explicit PointArrays (const std::span<const Point> points);
+
+    std::size_t
+    size () const {
+        return x.size();
+    }
+
+    Point
+    operator[] (const std::size_t i) const {
+        return Point{x[i], y[i]};
+    }
+
+    void
+    set (const std::size_t i, const Point& p) {
+        x[i] = p.x;
+        y[i] = p.y;
+    }
+
+    void
+    push_back (const Point& p) {
+        x.push_back (p.x);
+        y.push_back (p.y);
+    }
+
+    void
+    clear () {
+        x.clear();
+        y.clear();
+    }
+};
+
 #endif
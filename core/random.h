@@ -1,64 +1,190 @@
+//
+// random.h
+//
+// Random number generators
+//
+// The generators are driven by xoshiro256** (Blackman and Vigna, "Scrambled
+// Linear Pseudorandom Number Generators", 2018), whose state is only 32 bytes,
+// seeded by SplitMix64. So a generator is cheap to create, and the same seed
+// gives the same numbers on every platform. By default, the seed is fixed;
+// pass random_seed() for numbers which differ from run to run.
+//
+
+#ifndef __RANDOM_H__
+#define __RANDOM_H__
+
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <numbers>
 #include <random>
+#include <type_traits>
 
 #include "core/primitive.h"
 
+// Seed of the generators if not given
+inline constexpr std::uint64_t default_seed = 0;
+
+// Seed from std::random_device
+inline std::uint64_t
+random_seed () {
+    std::random_device rd;
+    return static_cast<std::uint64_t> (rd()) << 32 | rd();
+}
+
+// Next number of SplitMix64, advancing the state
+constexpr std::uint64_t
+splitmix64 (std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z               = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z               = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+//// struct xoshiro256
+
+// xoshiro256** engine. It satisfies std::uniform_random_bit_generator, so it
+// also drives the distributions of <random>.
+struct xoshiro256 {
+    using result_type = std::uint64_t;
+
+    explicit xoshiro256 (std::uint64_t seed = default_seed) {
+        for (auto& s : state) s = splitmix64 (seed);
+    }
+
+    static constexpr result_type
+    min () {
+        return 0;
+    }
+
+    static constexpr result_type
+    max () {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type
+    operator() () {
+        const std::uint64_t result = std::rotl (state[1] * 5, 7) * 9;
+        const std::uint64_t t      = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = std::rotl (state[3], 45);
+
+        return result;
+    }
+
+    // Advance the state as 2^128 calls would do.
+    void
+    jump () {
+        constexpr std::array<std::uint64_t, 4> polynomial{
+            0x180ec6d33cfd0abaull,
+            0xd5a61266f0c9392cull,
+            0xa9582618e03fc9aaull,
+            0x39abdc4529b1661cull
+        };
+
+        std::array<std::uint64_t, 4> jumped{};
+        for (const std::uint64_t word : polynomial) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & std::uint64_t{1} << b) {
+                    for (std::size_t k = 0; k < state.size(); ++k) jumped[k] ^= state[k];
+                }
+                (*this)();
+            }
+        }
+        state = jumped;
+    }
+
+    // Split off a generator for another thread: the generator returned
+    // continues from the current state, and this one jumps ahead, so their
+    // sequences do not overlap for 2^128 numbers.
+    xoshiro256
+    split () {
+        const xoshiro256 stream = *this;
+        jump();
+        return stream;
+    }
+
+    std::array<std::uint64_t, 4> state;
+};
+
 template <typename T> struct random_int_gen {
     // By default, random integral numbers are generated between the minimum
     // and maximum possible values.
     random_int_gen (
-        const T lower = std::numeric_limits<T>::min(),
-        const T upper = std::numeric_limits<T>::max()
-    ) {
-        // Create a random device to seed the generator
-        std::random_device rd;
-
-        // Use the Mersenne Twister engine
-        gen = std::mt19937 (rd());
-
-        // Define distributions
-        dist = std::uniform_int_distribution<T> (lower, upper);
-    }
+        const T             lower = std::numeric_limits<T>::min(),
+        const T             upper = std::numeric_limits<T>::max(),
+        const std::uint64_t seed  = default_seed
+    )
+        : gen{seed}
+        , lower{lower}
+        , count{static_cast<std::uint64_t> (upper) - static_cast<std::uint64_t> (lower) + 1}
+        , threshold{count == 0 ? 0 : (0 - count) % count} {}
 
     T
     operator() () {
-        return dist (gen);
+        // Reject the numbers below 2^64 mod count, so that the rest are evenly
+        // distributed over the count values.
+        std::uint64_t x = gen();
+        while (x < threshold) x = gen();
+
+        const std::uint64_t offset = count == 0 ? x : x % count;
+        return static_cast<T> (static_cast<std::uint64_t> (lower) + offset);
     }
 
-    std::mt19937                     gen;
-    std::uniform_int_distribution<T> dist;
+    xoshiro256          gen;
+    const T             lower;
+    const std::uint64_t count;  // 0 for all the 2^64 values
+    const std::uint64_t threshold;
 };
 
 template <typename T> struct random_float_gen {
-    // By default, random floating point numbers are generated between 0.0 and 1.0
-    random_float_gen (const T lower = T (0.), const T upper = T (1.)) {
-        // Create a random device to seed the generator
-        std::random_device rd;
-
-        // Use the Mersenne Twister engine
-        gen = std::mt19937 (rd());
-
-        // Define distributions
-        if constexpr (!std::is_floating_point_v<T>)
-            throw std::runtime_error ("The template parameter should be floating_point");
+    static_assert (std::is_floating_point_v<T>, "The template parameter should be floating_point");
 
-        dist = std::uniform_real_distribution<T> (lower, upper);
-    }
+    // By default, random floating point numbers are generated between 0.0 and 1.0
+    random_float_gen (
+        const T             lower = T (0.),
+        const T             upper = T (1.),
+        const std::uint64_t seed  = default_seed
+    )
+        : gen{seed}
+        , lower{lower}
+        , upper{upper}
+        , width{upper - lower} {}
 
     T
     operator() () {
-        return dist (gen);
+        // The upper bits, as many as T holds exactly up to 53, as a multiple of
+        // 2^-bits in [0, 1). More bits could round the unit up to 1.
+        constexpr int bits  = std::min (std::numeric_limits<T>::digits, 53);
+        constexpr T   scale = T (1.) / static_cast<T> (std::uint64_t{1} << bits);
+        const T       unit  = static_cast<T> (gen() >> (64 - bits)) * scale;
+
+        // The sum may still round up to the upper bound, e.g., 1 + (1 - 2^-53).
+        const T x = lower + width * unit;
+        return x < upper ? x : std::nextafter (upper, lower);
     }
 
-    std::mt19937                      gen;
-    std::uniform_real_distribution<T> dist;
+    xoshiro256 gen;
+    const T    lower;
+    const T    upper;
+    const T    width;
 };
 
 struct random_point_around_semicircle {
-    random_point_around_semicircle (const double angle = 0.0)
-        : base_angle{angle} {}
+    random_point_around_semicircle (
+        const double        angle = 0.0,
+        const std::uint64_t seed  = default_seed
+    )
+        : gen{0., 1., seed}
+        , base_angle{angle} {}
 
     Point
     operator() () {
@@ -69,3 +195,5 @@ struct random_point_around_semicircle {
     random_float_gen<double> gen;
     const double             base_angle;
 };
+
+#endif
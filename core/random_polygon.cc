@@ -0,0 +1,143 @@
+#include "core/random_polygon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <ranges>
+#include <vector>
+
+#include "core/edge_grid.h"
+#include "core/geometry.h"
+#include "core/intersection.h"
+#include "core/random.h"
+
+namespace {
+
+// Edges near a moved point, gathered from the grid, so that they are tested
+// at once by geometry::find_intersection. Kept from move to move, so that
+// their storage is reused.
+struct NearbyEdges {
+    PointArrays starts;
+    PointArrays ends;
+};
+
+// Check whether the edges (p_pre, p) and (p, p_nxt), which would replace the
+// two edges at the point i, intersect the other edges of the polygon. The
+// edge k connects the points k and k + 1, wrapping around the end.
+//
+// The new edges share p_pre and p_nxt with the edges next to them, so they
+// are allowed to touch those edges at the ends.
+bool
+has_self_intersection (
+    const Points&     polygon,
+    const EdgeGrid&   edges,
+    const std::size_t i,
+    const Point&      p,
+    NearbyEdges&      nearby
+) {
+    const std::size_t count_edges = polygon.size();
+    const auto        next        = [count_edges] (const std::size_t k) {
+        return k + 1 == count_edges ? 0 : k + 1;
+    };
+
+    const std::size_t e_pre    = (i + count_edges - 1) % count_edges;  // (p_pre, p)
+    const std::size_t e_nxt    = i;                                    // (p, p_nxt)
+    const std::size_t e_before = (i + count_edges - 2) % count_edges;  // Ends at p_pre
+    const std::size_t e_after  = next (i);                             // Starts at p_nxt
+
+    const auto intersects = [&] (const Point& a, const Point& b, const std::size_t adjacent) {
+        nearby.starts.clear();
+        nearby.ends.clear();
+
+        // The edge sharing an end point is tested by itself, with the end
+        // points ignored, and the others are gathered.
+        const bool touches_adjacent = edges.any_of (a, b, [&] (const std::size_t k) {
+            if (k == e_pre || k == e_nxt) return false;
+
+            const Point& r = polygon[k];
+            const Point& s = polygon[next (k)];
+            if (k == adjacent) {
+                return geometry::does_intersect (a, b, r, s, geometry::LineType::segment, true);
+            }
+            nearby.starts.push_back (r);
+            nearby.ends.push_back (s);
+            return false;
+        });
+        if (touches_adjacent) return true;
+
+        const std::size_t count = nearby.starts.size();
+        return geometry::find_intersection (
+                   a, b, nearby.starts, nearby.ends, 0, count, geometry::LineType::segment, false
+               ) != count;
+    };
+    return intersects (polygon[e_pre], p, e_before) || intersects (p, polygon[e_after], e_after);
+}
+
+}  // namespace
+
+// Place points around a circle
+Points
+place_points_around_circle (const double radius, const std::size_t count_points) {
+    const double inc = 2. * std::numbers::pi / count_points;
+
+    Points points (count_points);
+    for (std::size_t i = 0; i < count_points; ++i) {
+        const double angle = i * inc;
+        points[i]          = Point{radius * std::cos (angle), radius * std::sin (angle)};
+    }
+
+    return points;
+}
+
+// Generate random polygon
+//
+// Every move is checked only against the edges near the moved point, found in
+// a grid of the edges which is updated as the points move, so a pass over the
+// points takes O(n) time instead of O(n^2).
+Points
+random_polygon (const std::size_t count_points, const RandomPolygonOptions& options) {
+    Points polygon = place_points_around_circle (options.radius, count_points);
+    if (count_points < 3) return polygon;
+
+    // The moves, and so the edges, are sized after the distance between the
+    // points on the circle. The edges get a few times longer as the polygon
+    // wrinkles, and cells holding several of them are faster to search than
+    // small cells, which an edge spans many of.
+    const double spacing      = 2. * options.radius * std::sin (std::numbers::pi / count_points);
+    const double max_distance = options.max_step * spacing;
+
+    const auto next = [count_points] (const std::size_t k) {
+        return k + 1 == count_points ? 0 : k + 1;
+    };
+
+    EdgeGrid edges (8. * spacing, count_points);
+    for (std::size_t k = 0; k < count_points; ++k) {
+        edges.insert (k, polygon[k], polygon[next (k)]);
+    }
+
+    // Move points randomly without creating intersections
+    random_float_gen<double> random{0., 1., options.seed};
+    NearbyEdges              nearby;
+    for ([[maybe_unused]] int _ : std::views::iota (0, options.count_movements)) {
+        for (std::size_t i = 0; i < count_points; ++i) {
+            const double angle = random() * 2. * std::numbers::pi;
+            const double dist  = random() * max_distance;
+
+            const Point movement{dist * std::cos (angle), dist * std::sin (angle)};
+            const Point p_moved = polygon[i] + movement;
+
+            if (has_self_intersection (polygon, edges, i, p_moved, nearby)) continue;
+
+            const std::size_t i_pre = i == 0 ? count_points - 1 : i - 1;
+            const std::size_t i_nxt = next (i);
+
+            edges.remove (i_pre, polygon[i_pre], polygon[i]);
+            edges.remove (i, polygon[i], polygon[i_nxt]);
+            polygon[i] = p_moved;
+            edges.insert (i_pre, polygon[i_pre], polygon[i]);
+            edges.insert (i, polygon[i], polygon[i_nxt]);
+        }
+    }
+
+    return polygon;
+}
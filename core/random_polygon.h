@@ -0,0 +1,49 @@
+//
+// random_polygon.h
+//
+// Generate random simple polygons
+//
+// The points are placed around a circle, and then moved one by one in random
+// directions, as long as no edge of the polygon intersects another. Only the
+// edges near a point are checked when it moves, so a polygon of a million
+// points is generated in seconds.
+//
+
+#ifndef __RANDOM_POLYGON_H__
+#define __RANDOM_POLYGON_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/primitive.h"
+#include "core/random.h"
+
+//// Struct: RandomPolygonOptions
+
+struct RandomPolygonOptions {
+    // Radius of the circle where the points are placed first
+    double radius = 50.;
+
+    // Longest distance to move a point at a time, relative to the distance
+    // between two points next to each other on the circle
+    double max_step = 1.25;
+
+    // Number of times to move every point
+    int count_movements = 40;
+
+    // Seed of the random moves. The same seed gives the same polygon.
+    std::uint64_t seed = default_seed;
+};
+
+// `count_points` points placed evenly around a circle centered at the origin,
+// counter-clockwise from the positive x axis. The polygon is not closed.
+Points
+place_points_around_circle (const double radius, const std::size_t count_points);
+
+// A random simple polygon of `count_points` vertices, winding
+// counter-clockwise. The polygon is not closed, i.e., the first point is not
+// repeated at the end.
+Points
+random_polygon (const std::size_t count_points, const RandomPolygonOptions& options = {});
+
+#endif
@@ -0,0 +1,29 @@
+//
+// simd.h
+//
+// SIMD instructions available to the vectorized loops
+//
+// SSE2 is a part of every x86-64 processor. AVX2 is used if the compiler
+// targets it, or with GCC and Clang, if the processor running the program
+// supports it, which is checked at run time if TRIANGULATE_AVX2_RUNTIME_CHECK
+// is defined.
+//
+
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define TRIANGULATE_HAS_SSE2
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define TRIANGULATE_HAS_AVX2
+#define TRIANGULATE_AVX2_TARGET
+#elif defined(TRIANGULATE_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define TRIANGULATE_HAS_AVX2
+#define TRIANGULATE_AVX2_TARGET        __attribute__ ((target ("avx2")))
+#define TRIANGULATE_AVX2_RUNTIME_CHECK
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#include "core/spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+#include <vector>
+
+SpatialGrid::SpatialGrid (
+    const BoundingBox&         box,
+    const std::size_t          count,
+    std::pmr::memory_resource* resource
+)
+    : _origin{box.lower}
+    , _size{0}
+    , _cells{resource} {
+    // Guard against a degenerate (flat) box.
+    const double extent     = std::max (box.upper.x - box.lower.x, box.upper.y - box.lower.y);
+    const double min_extent = (extent > 0. ? extent : 1.) * 1e-6;
+    const double width      = std::max (box.upper.x - box.lower.x, min_extent);
+    const double height     = std::max (box.upper.y - box.lower.y, min_extent);
+
+    // Choose the number of columns and rows to make square cells.
+    const double count_cells = static_cast<double> (std::max<std::size_t> (count, 1));
+    const double cell_size   = std::sqrt (width * height / count_cells);
+
+    const auto count_cols = static_cast<std::size_t> (std::ceil (width / cell_size));
+    const auto count_rows = static_cast<std::size_t> (std::ceil (height / cell_size));
+
+    _cols = std::clamp<std::size_t> (count_cols, 1, count + 1);
+    _rows = std::clamp<std::size_t> (count_rows, 1, count + 1);
+
+    _inv_cell_width  = static_cast<double> (_cols) / width;
+    _inv_cell_height = static_cast<double> (_rows) / height;
+
+    _cells.resize (_cols * _rows);
+}
+
+void
+SpatialGrid::insert (const std::size_t idx, const Point& p) {
+    cell (p).push_back (idx);
+    ++_size;
+}
+
+// Remove a point. The location should be the one used to insert it.
+void
+SpatialGrid::remove (const std::size_t idx, const Point& p) {
+    auto& c  = cell (p);
+    auto  it = std::find (c.begin(), c.end(), idx);
+    if (it == c.end()) return;
+
+    *it = c.back();
+    c.pop_back();
+    --_size;
+}
+
+std::size_t
+SpatialGrid::column (const double x) const {
+    const double c = std::floor ((x - _origin.x) * _inv_cell_width);
+    if (!(c > 0.)) return 0;  // Also catches NaN
+    return std::min (static_cast<std::size_t> (c), _cols - 1);
+}
+
+std::size_t
+SpatialGrid::row (const double y) const {
+    const double r = std::floor ((y - _origin.y) * _inv_cell_height);
+    if (!(r > 0.)) return 0;
+    return std::min (static_cast<std::size_t> (r), _rows - 1);
+}
+
+std::pmr::vector<std::size_t>&
+SpatialGrid::cell (const Point& p) {
+    return _cells[row (p.y) * _cols + column (p.x)];
+}
@@ -0,0 +1,88 @@
+//
+// spatial_grid.h
+//
+// Uniform grid to look up points by location
+//
+
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "core/primitive.h"
+
+//// class SpatialGrid
+
+// The grid divides a bounding box into uniform cells, and each cell keeps the
+// indices of the points lying in it. Points can be inserted and removed at any
+// time, so the grid follows a point set which changes during an algorithm.
+class SpatialGrid {
+  public:
+    // Create a grid covering the box, whose cells are sized so that each of
+    // them holds about one point when `count` points are uniformly spread.
+    // The cells are allocated from the memory resource.
+    SpatialGrid (
+        const BoundingBox&         box,
+        const std::size_t          count,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    );
+
+    void
+    insert (const std::size_t idx, const Point& p);
+
+    // Remove a point. The location should be the one used to insert it.
+    void
+    remove (const std::size_t idx, const Point& p);
+
+    // Number of points in the grid
+    std::size_t
+    size () const {
+        return _size;
+    }
+
+    // Call `pred` with the index of every point in the cells overlapping the box,
+    // until it returns true. Returns whether any of the calls returned true.
+    //
+    // NOTE: the cells may contain points outside the box, so `pred` should
+    // check the location of the point by itself.
+    template <typename Predicate>
+    bool
+    any_of (const BoundingBox& box, Predicate pred) const {
+        const std::size_t col_begin = column (box.lower.x);
+        const std::size_t col_end   = column (box.upper.x);
+        const std::size_t row_begin = row (box.lower.y);
+        const std::size_t row_end   = row (box.upper.y);
+
+        for (std::size_t r = row_begin; r <= row_end; ++r) {
+            for (std::size_t c = col_begin; c <= col_end; ++c) {
+                for (const std::size_t idx : _cells[r * _cols + c]) {
+                    if (pred (idx)) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+  private:
+    std::size_t
+    column (const double x) const;
+
+    std::size_t
+    row (const double y) const;
+
+    std::pmr::vector<std::size_t>&
+    cell (const Point& p);
+
+  private:
+    Point                                           _origin;
+    double                                          _inv_cell_width;
+    double                                          _inv_cell_height;
+    std::size_t                                     _cols;
+    std::size_t                                     _rows;
+    std::size_t                                     _size;
+    std::pmr::vector<std::pmr::vector<std::size_t>> _cells;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "core/stream.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "core/triangulator.h"
+
+namespace {
+
+//// class BoundedQueue
+
+// Queue between two threads, which blocks the producer while it is full and
+// the consumer while it is empty. Once closed, push fails and pop returns the
+// remaining items and then std::nullopt.
+template <typename T> class BoundedQueue {
+  public:
+    explicit BoundedQueue (const std::size_t capacity)
+        : _capacity{std::max<std::size_t> (1, capacity)} {}
+
+    // Returns false if the queue is closed.
+    bool
+    push (T item) {
+        std::unique_lock<std::mutex> lock (_mutex);
+        _not_full.wait (lock, [this] { return _closed || _items.size() < _capacity; });
+        if (_closed) return false;
+
+        _items.push_back (std::move (item));
+        _not_empty.notify_one();
+        return true;
+    }
+
+    std::optional<T>
+    pop () {
+        std::unique_lock<std::mutex> lock (_mutex);
+        _not_empty.wait (lock, [this] { return _closed || !_items.empty(); });
+        if (_items.empty()) return std::nullopt;
+
+        T item = std::move (_items.front());
+        _items.pop_front();
+        _not_full.notify_one();
+        return item;
+    }
+
+    void
+    close () {
+        {
+            std::lock_guard<std::mutex> lock (_mutex);
+            _closed = true;
+        }
+        _not_full.notify_all();
+        _not_empty.notify_all();
+    }
+
+  private:
+    const std::size_t       _capacity;
+    std::mutex              _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+    std::deque<T>           _items;
+    bool                    _closed = false;
+};
+
+}  // namespace
+
+// Call `read` until it returns std::nullopt, triangulate every polygon as soon
+// as it is read, and pass the results to `write` in the order of the polygons.
+std::size_t
+triangulate_stream (
+    const std::function<std::optional<Points> ()>&    read,
+    const std::function<void (const Triangulation&)>& write,
+    const StreamOptions&                              options
+) {
+    BoundedQueue<Points>        polygons (options.queue_capacity);
+    BoundedQueue<Triangulation> results (options.queue_capacity);
+
+    // The first exception thrown by any stage, which closes both queues to
+    // stop the other stages
+    std::mutex         error_mutex;
+    std::exception_ptr error;
+    const auto         fail = [&] () {
+        {
+            std::lock_guard<std::mutex> lock (error_mutex);
+            if (!error) error = std::current_exception();
+        }
+        polygons.close();
+        results.close();
+    };
+
+    std::thread reader ([&] () {
+        try {
+            while (std::optional<Points> points = read()) {
+                if (!polygons.push (std::move (*points))) break;
+            }
+            polygons.close();
+        } catch (...) {
+            fail();
+        }
+    });
+
+    std::thread triangulator ([&] () {
+        try {
+            Triangulator workspace;
+            while (std::optional<Points> points = polygons.pop()) {
+                const Polygon polygon{std::move (*points)};
+                if (!results.push (workspace.triangulate (polygon, options.triangulation))) break;
+            }
+            results.close();
+        } catch (...) {
+            fail();
+        }
+    });
+
+    std::size_t count = 0;
+    try {
+        while (const std::optional<Triangulation> result = results.pop()) {
+            write (*result);
+            count++;
+        }
+    } catch (...) {
+        fail();
+    }
+
+    reader.join();
+    triangulator.join();
+
+    if (error) std::rethrow_exception (error);
+    return count;
+}
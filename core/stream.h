@@ -0,0 +1,47 @@
+//
+// stream.h
+//
+// Triangulate a long sequence of polygons as a pipeline
+//
+// A reader thread produces the polygons, a triangulation thread triangulates
+// them one by one, and the calling thread consumes the results, all at the
+// same time. The stages are connected by bounded queues, so the memory in use
+// depends on the size of the largest polygon, not on the number of polygons.
+//
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+#include "core/polygon.h"
+#include "core/primitive.h"
+
+//// Struct: StreamOptions
+
+struct StreamOptions {
+    // Number of polygons, or results, which may wait between two stages
+    std::size_t queue_capacity = 4;
+
+    // Options for every triangulation
+    // NOTE: the observer, if any, is called from the triangulation thread.
+    TriangulationOptions triangulation;
+};
+
+// Call `read` until it returns std::nullopt, triangulate every polygon as soon
+// as it is read, and pass the results to `write` in the order of the polygons.
+// Returns the number of the polygons.
+//
+// `read` is called from a thread of its own, and `write` from the calling
+// thread. If any of them, or a triangulation, throws, the pipeline stops and
+// the first exception is rethrown.
+std::size_t
+triangulate_stream (
+    const std::function<std::optional<Points> ()>&    read,
+    const std::function<void (const Triangulation&)>& write,
+    const StreamOptions&                              options = {}
+);
+
+#endif
@@ -0,0 +1,159 @@
+#include "core/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace {
+// Whether the current thread is running a task of a pool
+thread_local bool inside_task = false;
+}  // namespace
+
+ThreadPool::ThreadPool (const std::size_t count_threads) {
+    const std::size_t count =
+        count_threads > 0 ? count_threads
+                          : std::max<std::size_t> (1, std::thread::hardware_concurrency());
+
+    for (std::size_t i = 0; i < count; ++i) {
+        _queues.push_back (std::make_unique<WorkQueue>());
+    }
+
+    // The calling thread works as the worker 0.
+    for (std::size_t i = 1; i < count; ++i) {
+        _threads.emplace_back ([this, i] { worker_loop (i); });
+    }
+}
+
+ThreadPool::~ThreadPool () {
+    {
+        std::lock_guard<std::mutex> lock (_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void
+ThreadPool::for_each (const std::size_t count, const std::function<void (std::size_t)>& task) {
+    if (count == 0) return;
+
+    // A task waiting for the other tasks of the same pool would block the
+    // thread they may be queued on, so a nested call runs them here.
+    if (inside_task || size() == 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task (i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit_lock (_submit_mutex);
+
+    // A thread still looking for the tasks of the previous job may take one of
+    // this job as soon as it is queued, so the job is set up first.
+    {
+        std::lock_guard<std::mutex> lock (_mutex);
+        _task    = &task;
+        _pending = count;
+        _error   = nullptr;
+        _generation++;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        WorkQueue&                  queue = *_queues[i % size()];
+        std::lock_guard<std::mutex> lock (queue.mutex);
+        queue.indices.push_back (i);
+    }
+    _wake.notify_all();
+
+    work (0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock (_mutex);
+        _done.wait (lock, [this] { return _pending == 0; });
+        _task = nullptr;
+        error = std::exchange (_error, nullptr);
+    }
+
+    if (error) std::rethrow_exception (error);
+}
+
+void
+ThreadPool::worker_loop (const std::size_t worker) {
+    std::uint64_t generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock (_mutex);
+            _wake.wait (lock, [&] { return _stop || _generation != generation; });
+            if (_stop) return;
+            generation = _generation;
+        }
+        work (worker);
+    }
+}
+
+// Run the tasks of the current job until no queue has any left.
+void
+ThreadPool::work (const std::size_t worker) {
+    while (true) {
+        std::optional<std::size_t> idx = pop (worker);
+        if (!idx.has_value()) idx = steal (worker);
+        if (!idx.has_value()) return;
+
+        // The job cannot finish before this task does, so _task stays valid.
+        const std::function<void (std::size_t)>* task;
+        {
+            std::lock_guard<std::mutex> lock (_mutex);
+            task = _task;
+        }
+
+        std::exception_ptr error;
+        inside_task = true;
+        try {
+            (*task) (*idx);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        inside_task = false;
+
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock (_mutex);
+            if (error && !_error) _error = error;
+            finished = --_pending == 0;
+        }
+        if (finished) _done.notify_all();
+    }
+}
+
+std::optional<std::size_t>
+ThreadPool::pop (const std::size_t worker) {
+    WorkQueue&                  queue = *_queues[worker];
+    std::lock_guard<std::mutex> lock (queue.mutex);
+    if (queue.indices.empty()) return std::nullopt;
+
+    const std::size_t idx = queue.indices.front();
+    queue.indices.pop_front();
+    return idx;
+}
+
+std::optional<std::size_t>
+ThreadPool::steal (const std::size_t thief) {
+    for (std::size_t i = 1; i < size(); ++i) {
+        WorkQueue&                  queue = *_queues[(thief + i) % size()];
+        std::lock_guard<std::mutex> lock (queue.mutex);
+        if (queue.indices.empty()) continue;
+
+        const std::size_t idx = queue.indices.back();
+        queue.indices.pop_back();
+        return idx;
+    }
+    return std::nullopt;
+}
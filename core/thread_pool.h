@@ -0,0 +1,92 @@
+//
+// thread_pool.h
+//
+// Work-stealing pool of threads to run independent tasks in parallel
+//
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+//// class ThreadPool
+
+// Each thread owns a queue of task indices. A thread takes the tasks from the
+// front of its own queue, and when it runs out of them, steals from the back of
+// the other queues. The calling thread works as one of the threads, so a pool
+// of size 1 runs everything on the calling thread.
+class ThreadPool {
+  public:
+    // Create a pool of `count_threads` threads, including the calling thread.
+    // If zero, the number of hardware threads is used.
+    explicit ThreadPool (const std::size_t count_threads = 0);
+
+    ThreadPool (const ThreadPool&) = delete;
+    ThreadPool&
+    operator= (const ThreadPool&) = delete;
+
+    ~ThreadPool ();
+
+    // Number of threads, including the calling thread
+    std::size_t
+    size () const {
+        return _queues.size();
+    }
+
+    // Call task(i) for every i in [0, count), and wait until all of them finish.
+    // The indices are dealt to the threads in round robin, so every thread
+    // starts with the tasks which come first, e.g., the largest ones.
+    // If any task throws, the first exception is rethrown after the others finish.
+    //
+    // NOTE: a call from inside a task runs all of its tasks on the current thread.
+    void
+    for_each (const std::size_t count, const std::function<void (std::size_t)>& task);
+
+  private:
+    struct WorkQueue {
+        std::mutex              mutex;
+        std::deque<std::size_t> indices;
+    };
+
+    void
+    worker_loop (const std::size_t worker);
+
+    // Run the tasks of the current job until no queue has any left.
+    void
+    work (const std::size_t worker);
+
+    std::optional<std::size_t>
+    pop (const std::size_t worker);
+
+    std::optional<std::size_t>
+    steal (const std::size_t thief);
+
+  private:
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    std::vector<std::thread>                _threads;
+
+    // Serializes the calls to for_each.
+    std::mutex _submit_mutex;
+
+    // State of the current job, guarded by _mutex
+    std::mutex                               _mutex;
+    std::condition_variable                  _wake;
+    std::condition_variable                  _done;
+    const std::function<void (std::size_t)>* _task       = nullptr;
+    std::size_t                              _pending    = 0;
+    std::uint64_t                            _generation = 0;
+    std::exception_ptr                       _error;
+    bool                                     _stop = false;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "core/tikz_progress.h"
+
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "core/fileio.h"
+
+TikzProgressObserver::TikzProgressObserver (const std::string& filename, const double scale)
+    : _filename{filename}
+    , _scale{scale} {}
+
+void
+TikzProgressObserver::on_begin ([[maybe_unused]] const std::span<const Point> points) {
+    _file = std::ofstream{_filename};
+
+    if (!_file.is_open()) {
+        throw std::runtime_error ("Failed to open file: " + _filename);
+    }
+    _file << "\\input tikz.tex\n"
+          << "\\baselineskip=12pt\n"
+          << "\\hsize=6.3truein\n"
+          << "\\vsize=8.7truein\n"
+          << "\\nopagenumbers\n";
+}
+
+void
+TikzProgressObserver::on_ear_clipped (
+    const std::span<const Point> points,
+    const VertexRing&            ring,
+    const Triangles&             triangles
+) {
+    append_page (points, ring, triangles);
+}
+
+void
+TikzProgressObserver::on_end (
+    const std::span<const Point> points,
+    const VertexRing&            ring,
+    const Triangles&             triangles
+) {
+    append_page (points, ring, triangles);
+
+    _file << "\\vfill\\eject\n" << "\\bye\n";
+    _file.close();
+}
+
+void
+TikzProgressObserver::append_page (
+    const std::span<const Point> points,
+    const VertexRing&            ring,
+    const Triangles&             triangles
+) {
+    _buffer.clear();
+    _buffer += "Triangulation:\n"
+               "\\vskip12pt\n";
+
+    fileio::append_tikz_polygon (_buffer, points, ring.clipped_mask(), triangles, _scale);
+
+    _buffer += "\\vfill\\eject\n";
+    _file << _buffer;
+}
@@ -0,0 +1,59 @@
+//
+// tikz_progress.h
+//
+// Observer writing every step of a triangulation in TeX with TikZ
+//
+
+#ifndef __TIKZ_PROGRESS_H__
+#define __TIKZ_PROGRESS_H__
+
+#include <fstream>
+#include <span>
+#include <string>
+
+#include "core/observer.h"
+#include "core/primitive.h"
+#include "core/vertex_ring.h"
+
+//// class TikzProgressObserver
+
+// Draws the remaining polygon and the triangles registered so far, on a new
+// page for every ear clipped. The output is O(n^2) in the number of vertices,
+// so this is meant for small polygons, e.g., to make an animation.
+class TikzProgressObserver : public TriangulationObserver {
+  public:
+    TikzProgressObserver (const std::string& filename, const double scale = 0.25);
+
+    void
+    on_begin (const std::span<const Point> points) override;
+
+    void
+    on_ear_clipped (
+        const std::span<const Point> points,
+        const VertexRing&            ring,
+        const Triangles&             triangles
+    ) override;
+
+    void
+    on_end (
+        const std::span<const Point> points,
+        const VertexRing&            ring,
+        const Triangles&             triangles
+    ) override;
+
+  private:
+    void
+    append_page (
+        const std::span<const Point> points,
+        const VertexRing&            ring,
+        const Triangles&             triangles
+    );
+
+  private:
+    std::string   _filename;
+    double        _scale;
+    std::ofstream _file;
+    std::string   _buffer;  // Text of a page, reused for every page
+};
+
+#endif
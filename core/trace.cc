@@ -0,0 +1,66 @@
+#include "core/trace.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+//// NAMESPACE: trace
+
+namespace trace {
+
+namespace {
+Sink sink;
+}  // namespace
+
+// Set the sink and the kinds of events (mask_of(kind) combined) delivered to
+// it. This should not be called while tracing.
+void
+set_sink (Sink s, const std::uint32_t mask) {
+    sink = std::move (s);
+    detail::enabled_events.store (sink ? mask : 0, std::memory_order_relaxed);
+}
+
+// Remove the sink and disable all events.
+void
+reset_sink () {
+    set_sink (nullptr, 0);
+}
+
+// Deliver an event to the sink.
+void
+emit (const Event& event) {
+    if (sink) sink (event);
+}
+
+// Symbol of the event, e.g., 'x' for EventKind::degenerate_vertex.
+char
+symbol (const EventKind kind) {
+    switch (kind) {
+    case EventKind::reflex_vertex: return 'o';
+    case EventKind::degenerate_vertex: return 'x';
+    case EventKind::ear_blocked: return '+';
+    case EventKind::ear_found: return 'e';
+    case EventKind::ear_clipped: return '*';
+    case EventKind::no_ear: return '!';
+    default: return '?';
+    }
+}
+
+// Sink printing an event per line, e.g., "12, 13, 14 : *".
+Sink
+ostream_sink (std::ostream& os) {
+    auto mutex = std::make_shared<std::mutex>();
+
+    return [&os, mutex] (const Event& event) {
+        std::lock_guard<std::mutex> lock (*mutex);
+
+        os << event.prev << ", " << event.vertex << ", " << event.next << " : "
+           << symbol (event.kind);
+        if (event.other != Event::none) os << ' ' << event.other;
+        os << '\n';
+    };
+}
+
+}  // namespace trace
@@ -0,0 +1,127 @@
+//
+// trace.h
+//
+// Structured tracing of the steps taken by the algorithms
+//
+// An event is reported through the macro TRIANGULATE_TRACE, e.g.,
+//
+//   TRIANGULATE_TRACE (trace::EventKind::ear_clipped, idx_vp, idx_v, idx_vn);
+//
+// Every kind of event has a level. The events whose level is above
+// TRIANGULATE_TRACE_LEVEL are removed at compile time, and the others are
+// delivered to the sink only when their kinds are enabled at run time.
+//
+// By default, TRIANGULATE_TRACE_LEVEL is 0 (no event at all) if NDEBUG is
+// defined, i.e., in release builds, and 3 (every event) otherwise.
+//
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+
+#ifndef TRIANGULATE_TRACE_LEVEL
+#ifdef NDEBUG
+#define TRIANGULATE_TRACE_LEVEL 0
+#else
+#define TRIANGULATE_TRACE_LEVEL 3
+#endif
+#endif
+
+//// NAMESPACE: trace
+
+namespace trace {
+
+// .info: a few events per call, e.g., the triangulation is incomplete
+// .debug: an event per step, e.g., an ear is clipped
+// .verbose: an event per test, e.g., a vertex is found to be reflex
+enum class Level { off = 0, info = 1, debug = 2, verbose = 3 };
+
+// Symbols in parentheses are the ones printed by ostream_sink.
+enum class EventKind : std::uint32_t {
+    reflex_vertex,      // (o) vertex is not convex, so it is not an ear
+    degenerate_vertex,  // (x) edges at the vertex overlap, so it is removed
+    ear_blocked,        // (+) triangle at the vertex contains another vertex
+    ear_found,          // (e) vertex is an ear
+    ear_clipped,        // (*) ear is clipped and the triangle is registered
+    no_ear,             // (!) no ear is left, so the triangulation stops
+    count
+};
+
+constexpr Level
+level_of (const EventKind kind) {
+    switch (kind) {
+    case EventKind::ear_clipped: return Level::debug;
+    case EventKind::no_ear: return Level::info;
+    default: return Level::verbose;
+    }
+}
+
+constexpr std::uint32_t
+mask_of (const EventKind kind) {
+    return std::uint32_t{1} << static_cast<std::uint32_t> (kind);
+}
+
+constexpr std::uint32_t all_events =
+    (std::uint32_t{1} << static_cast<std::uint32_t> (EventKind::count)) - 1;
+
+// The triangle (prev, vertex, next) being tested or clipped.
+// `other` is the vertex blocking an ear, if any.
+struct Event {
+    static constexpr std::size_t none = static_cast<std::size_t> (-1);
+
+    EventKind   kind;
+    std::size_t prev   = none;
+    std::size_t vertex = none;
+    std::size_t next   = none;
+    std::size_t other  = none;
+};
+
+// A sink receives the events from all threads, so it should be thread-safe
+// when the triangulations run concurrently.
+using Sink = std::function<void (const Event&)>;
+
+// Set the sink and the kinds of events (mask_of(kind) combined) delivered to
+// it. This should not be called while tracing.
+void
+set_sink (Sink sink, const std::uint32_t mask = all_events);
+
+// Remove the sink and disable all events.
+void
+reset_sink ();
+
+namespace detail {
+inline std::atomic<std::uint32_t> enabled_events{0};
+}  // namespace detail
+
+inline bool
+is_enabled (const EventKind kind) {
+    return (detail::enabled_events.load (std::memory_order_relaxed) & mask_of (kind)) != 0;
+}
+
+// Deliver an event to the sink.
+void
+emit (const Event& event);
+
+// Symbol of the event, e.g., 'x' for EventKind::degenerate_vertex.
+char
+symbol (const EventKind kind);
+
+// Sink printing an event per line, e.g., "12, 13, 14 : *".
+Sink
+ostream_sink (std::ostream& os);
+
+}  // namespace trace
+
+#define TRIANGULATE_TRACE(kind, ...)                                                                \
+    do {                                                                                           \
+        if constexpr (static_cast<int> (trace::level_of (kind)) <= TRIANGULATE_TRACE_LEVEL) {      \
+            if (trace::is_enabled (kind)) trace::emit (trace::Event{(kind), __VA_ARGS__});         \
+        }                                                                                          \
+    } while (false)
+
+#endif
@@ -0,0 +1,73 @@
+#include "core/triangulator.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace {
+
+//// class OverflowResource
+
+// Upstream of the arena, which counts the bytes allocated when the buffer of
+// the arena runs out
+class OverflowResource : public std::pmr::memory_resource {
+  public:
+    std::size_t
+    allocated () const {
+        return _allocated;
+    }
+
+  private:
+    void*
+    do_allocate (const std::size_t bytes, const std::size_t alignment) override {
+        _allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate (bytes, alignment);
+    }
+
+    void
+    do_deallocate (void* p, const std::size_t bytes, const std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate (p, bytes, alignment);
+    }
+
+    bool
+    do_is_equal (const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+  private:
+    std::size_t _allocated = 0;
+};
+
+}  // namespace
+
+// Triangulate the polygon as BasicPolygonView::triangulation() does. The
+// result is valid until the next call.
+template <typename T>
+const Triangulation&
+Triangulator::triangulate (
+    const BasicPolygonView<T>&  polygon,
+    const TriangulationOptions& options
+) {
+    OverflowResource overflow;
+    {
+        // Everything allocated from the arena is released at the end of the
+        // scope at once, and the buffer is used again by the next call.
+        std::pmr::monotonic_buffer_resource arena (_arena.get(), _arena_size, &overflow);
+        polygon.triangulate_into (options, &arena, _result);
+    }
+
+    // Grow the buffer to hold the whole workspace next time.
+    if (overflow.allocated() > 0) {
+        _arena_size += overflow.allocated();
+        _arena.reset (new std::byte[_arena_size]);
+    }
+
+    return _result;
+}
+
+template const Triangulation&
+Triangulator::triangulate (const PolygonViewF&, const TriangulationOptions&);
+template const Triangulation&
+Triangulator::triangulate (const PolygonView&, const TriangulationOptions&);
+template const Triangulation&
+Triangulator::triangulate (const PolygonViewI&, const TriangulationOptions&);
@@ -0,0 +1,56 @@
+//
+// triangulator.h
+//
+// Triangulate many polygons one after another without allocating memory for
+// each of them
+//
+
+#ifndef __TRIANGULATOR_H__
+#define __TRIANGULATOR_H__
+
+#include <cstddef>
+#include <memory>
+
+#include "core/polygon.h"
+
+//// class Triangulator
+
+// A triangulator owns a workspace reused from polygon to polygon. The vertex
+// ring, the ear queue and the spatial index of the ear clipping are allocated
+// from an arena, which is reset after each polygon instead of freed, and the
+// triangles are written to a buffer which keeps its capacity.
+//
+// The arena grows to the largest workspace needed so far, so after the first
+// few polygons, triangulating a polygon allocates no memory, except with
+// Algorithm::monotone, which does not use the arena.
+//
+// A triangulator is not thread-safe; use one for each thread.
+class Triangulator {
+  public:
+    Triangulator () = default;
+
+    // Triangulate the polygon as BasicPolygonView::triangulation() does, for
+    // the coordinate types the view is instantiated for. The result is valid
+    // until the next call.
+    template <typename T>
+    const Triangulation&
+    triangulate (const BasicPolygonView<T>& polygon, const TriangulationOptions& options = {});
+
+    const Triangulation&
+    triangulate (const Polygon& polygon, const TriangulationOptions& options = {}) {
+        return triangulate (polygon.view(), options);
+    }
+
+    // Size of the arena in bytes
+    std::size_t
+    arena_size () const {
+        return _arena_size;
+    }
+
+  private:
+    std::unique_ptr<std::byte[]> _arena;
+    std::size_t                  _arena_size = 0;
+    Triangulation                _result;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "core/vertex_ring.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+VertexRing::VertexRing (const std::size_t count, std::pmr::memory_resource* resource)
+    : _prev (count, resource)
+    , _next (count, resource)
+    , _remaining{count} {
+    for (std::size_t i = 0; i < count; ++i) {
+        _prev[i] = (i == 0 ? count : i) - 1;
+        _next[i] = (i + 1 == count ? 0 : i + 1);
+    }
+}
+
+// Remove (clip) a vertex from the ring by linking its neighbors.
+void
+VertexRing::remove (const std::size_t idx) {
+    if (!contains (idx)) return;
+
+    const std::size_t p = _prev[idx];
+    const std::size_t n = _next[idx];
+
+    _next[p] = n;
+    _prev[n] = p;
+
+    _prev[idx] = npos;
+    _next[idx] = npos;
+    --_remaining;
+}
+
+// Flags marking the removed vertices, indexed by the vertex index.
+std::vector<bool>
+VertexRing::clipped_mask () const {
+    std::vector<bool> clipped (_next.size(), false);
+    for (std::size_t i = 0; i < _next.size(); ++i) {
+        clipped[i] = !contains (i);
+    }
+    return clipped;
+}
@@ -0,0 +1,66 @@
+//
+// vertex_ring.h
+//
+// Doubly-linked ring of polygon vertices used during triangulation
+//
+
+#ifndef __VERTEX_RING_H__
+#define __VERTEX_RING_H__
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+//// class VertexRing
+
+// The ring keeps the indices of the vertices which are not clipped yet.
+// The links are stored in two contiguous index arrays, so that both looking up
+// the neighbors of a vertex and removing a vertex from the ring take O(1) time.
+class VertexRing {
+  public:
+    // Create a ring of the vertices 0, 1, ..., count - 1 (in this order),
+    // whose links are allocated from the memory resource.
+    explicit VertexRing (
+        const std::size_t          count,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    );
+
+    // Number of vertices remaining in the ring
+    std::size_t
+    size () const {
+        return _remaining;
+    }
+
+    // Whether the vertex is still in the ring, i.e., not clipped
+    bool
+    contains (const std::size_t idx) const {
+        return _next[idx] != npos;
+    }
+
+    std::size_t
+    next (const std::size_t idx) const {
+        return _next[idx];
+    }
+
+    std::size_t
+    prev (const std::size_t idx) const {
+        return _prev[idx];
+    }
+
+    // Remove (clip) a vertex from the ring by linking its neighbors.
+    void
+    remove (const std::size_t idx);
+
+    // Flags marking the removed vertices, indexed by the vertex index.
+    std::vector<bool>
+    clipped_mask () const;
+
+  private:
+    static constexpr std::size_t npos = static_cast<std::size_t> (-1);
+
+    std::pmr::vector<std::size_t> _prev;
+    std::pmr::vector<std::size_t> _next;
+    std::size_t                   _remaining;
+};
+
+#endif
@@ -1,14 +1,37 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <numbers>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
+#include "core/batch.h"
+#include "core/cache.h"
+#include "core/fileio.h"
 #include "core/geometry.h"
+#include "core/incremental.h"
+#include "core/intersection.h"
+#include "core/metrics.h"
 #include "core/numeric.h"
 #include "core/polygon.h"
+#include "core/predicates.h"
 #include "core/primitive.h"
 #include "core/random.h"
+#include "core/random_polygon.h"
+#include "core/stream.h"
+#include "core/thread_pool.h"
+#include "core/trace.h"
+#include "core/triangulator.h"
 
 //// For a limited form of QuickCheck
 constexpr std::size_t max_test_count = 65536;
@@ -87,6 +110,291 @@ TEST (GeometryTest, Intersection) {
     }
 }
 
+TEST (GeometryTest, IntersectionKernel) {
+    // Points on a small integer grid make many segments which are parallel,
+    // collinear, or touching at the ends, in addition to the general ones.
+    random_int_gen<int> gen{0, 4};
+
+    PointArrays polyline;
+    for (int i = 0; i < 203; ++i) {
+        polyline.x.push_back (gen());
+        polyline.y.push_back (gen());
+    }
+    const std::size_t count_segments = polyline.size() - 1;
+
+    // The same segments, each stored separately and from the other end
+    PointArrays starts, ends;
+    for (std::size_t k = 0; k < count_segments; ++k) {
+        starts.push_back (polyline[k + 1]);
+        ends.push_back (polyline[k]);
+    }
+
+    for (std::size_t test = 0; test < 256; ++test) {
+        const Point p{static_cast<double> (gen()), static_cast<double> (gen())};
+        const Point q{static_cast<double> (gen()), static_cast<double> (gen())};
+        const std::size_t begin = test % 7;
+
+        for (const auto line_type : {geometry::LineType::segment,
+                                     geometry::LineType::ray,
+                                     geometry::LineType::infinite_line}) {
+            for (const bool ignore_endpoints : {true, false}) {
+                std::size_t first          = count_segments;
+                std::size_t first_separate = count_segments;
+                std::size_t count          = 0;
+                for (std::size_t k = count_segments; k-- > begin;) {
+                    if (geometry::does_intersect (
+                            p, q, polyline[k], polyline[k + 1], line_type, ignore_endpoints
+                        )) {
+                        first = k;
+                        count++;
+                    }
+                    if (geometry::does_intersect (
+                            p, q, starts[k], ends[k], line_type, ignore_endpoints
+                        )) {
+                        first_separate = k;
+                    }
+                }
+
+                EXPECT_EQ (
+                    geometry::find_intersection (
+                        p, q, polyline, begin, count_segments, line_type, ignore_endpoints
+                    ),
+                    first
+                );
+                EXPECT_EQ (
+                    geometry::count_intersections (
+                        p, q, polyline, begin, count_segments, line_type, ignore_endpoints
+                    ),
+                    count
+                );
+                EXPECT_EQ (
+                    geometry::find_intersection (
+                        p, q, starts, ends, begin, count_segments, line_type, ignore_endpoints
+                    ),
+                    first_separate
+                );
+            }
+        }
+    }
+}
+
+TEST (GeometryTest, IntersectionKernelNearlyCollinear) {
+    // Points a few ulps off the line y = x, whose orientations w.r.t. a line
+    // along y = x are too close to 0 for the floating-point filter.
+    random_int_gen<int> gen{-2, 2};
+
+    PointArrays polyline;
+    for (int i = 0; i < 67; ++i) {
+        const double t = 0.5 + i / 64.;
+        polyline.x.push_back (t);
+        polyline.y.push_back (t + gen() * std::numeric_limits<double>::epsilon());
+    }
+    const std::size_t count_segments = polyline.size() - 1;
+
+    const Point p{0., 0.};
+    for (const Point& q : {Point{1., 1.}, Point{1.5, 1.5}, Point{2., 2.}}) {
+        for (const bool ignore_endpoints : {true, false}) {
+            std::size_t count = 0;
+            for (std::size_t k = 0; k < count_segments; ++k) {
+                if (geometry::does_intersect (
+                        p, q, polyline[k], polyline[k + 1], geometry::LineType::segment,
+                        ignore_endpoints
+                    ))
+                    count++;
+            }
+            EXPECT_EQ (
+                geometry::count_intersections (
+                    p, q, polyline, 0, count_segments, geometry::LineType::segment,
+                    ignore_endpoints
+                ),
+                count
+            );
+        }
+    }
+}
+
+//// Test Predicates
+TEST (PredicatesTest, Orient2d) {
+    // Points within a few ulps of (0.5, 0.5) against the line through (12, 12)
+    // and (24, 24), i.e., y = x. The naive cross product gets many of the
+    // signs wrong.
+    const Point b{12., 12.};
+    const Point c{24., 24.};
+    const double ulp = std::numeric_limits<double>::epsilon() / 2.;
+
+    for (int i = 0; i < 32; ++i) {
+        for (int j = 0; j < 32; ++j) {
+            const Point a{0.5 + i * ulp, 0.5 + j * ulp};
+            const int   expected = (j > i) - (j < i);
+            EXPECT_EQ (numeric::sign (predicates::orient2d (a, b, c)), expected);
+            EXPECT_EQ (numeric::sign (geometry::orientation (a, b, c)), expected);
+        }
+    }
+}
+
+TEST (PredicatesTest, Incircle) {
+    // Points on the circle of radius 5 centered at the origin
+    const Point a{5., 0.};
+    const Point b{0., 5.};
+    const Point c{-5., 0.};
+
+    EXPECT_EQ (predicates::incircle (a, b, c, Point{3., 4.}), 0.);
+    EXPECT_EQ (predicates::incircle (a, b, c, Point{-4., -3.}), 0.);
+    EXPECT_GT (predicates::incircle (a, b, c, Point{0., 0.}), 0.);
+    EXPECT_LT (predicates::incircle (a, b, c, Point{5., 5.}), 0.);
+
+    // Off the circle by an ulp
+    const double ulp = std::numeric_limits<double>::epsilon() * 4.;
+    EXPECT_GT (predicates::incircle (a, b, c, Point{3., 4. - ulp}), 0.);
+    EXPECT_LT (predicates::incircle (a, b, c, Point{3., 4. + ulp}), 0.);
+
+    // The sign is reversed if (a, b, c) winds clockwise.
+    EXPECT_LT (predicates::incircle (c, b, a, Point{0., 0.}), 0.);
+}
+
+//// File I/O
+TEST (FileIoTest, ParseCsvPoints) {
+    const Points points = fileio::parse_csv_points (
+        "0.5, 1\n"
+        "-2,3e-1\r\n"
+        "\n"
+        "  +4.25 ,\t-0.125, ignored\n"
+        "no comma\n"
+        "1e3,2"
+    );
+
+    ASSERT_EQ (points.size(), 4);
+    EXPECT_EQ (points[0], (Point{0.5, 1.}));
+    EXPECT_EQ (points[1], (Point{-2., 0.3}));
+    EXPECT_EQ (points[2], (Point{4.25, -0.125}));
+    EXPECT_EQ (points[3], (Point{1000., 2.}));
+
+    EXPECT_THROW (fileio::parse_csv_points ("1, 2\n3, x\n"), std::invalid_argument);
+    EXPECT_THROW (fileio::parse_csv_points ("1, 2.5.1\n"), std::invalid_argument);
+}
+
+TEST (FileIoTest, ReadCsvPoints) {
+    random_float_gen<double> gen;
+
+    Points points;
+    for (int i = 0; i < 1000; ++i) points.push_back (Point{gen(), gen()});
+
+    const std::string filename = testing::TempDir() + "read_csv_points.csv";
+    fileio::write_points_csv_file (points, filename);
+
+    // The coordinates are written without loss.
+    EXPECT_EQ (fileio::read_csv_points (filename), points);
+
+    EXPECT_THROW (fileio::read_csv_points (filename + ".missing"), std::runtime_error);
+}
+
+TEST (FileIoTest, PolygonFile) {
+    random_float_gen<double> gen;
+
+    std::vector<Points> polygons (4);
+    for (std::size_t i = 0; i < polygons.size(); ++i) {
+        // The third polygon is left empty.
+        if (i == 2) continue;
+        for (std::size_t k = 0; k < 10 * i + 3; ++k) polygons[i].push_back (Point{gen(), gen()});
+    }
+
+    const std::string filename = testing::TempDir() + "polygon_file.bin";
+    fileio::write_polygons_binary (polygons, filename);
+
+    const fileio::PolygonFile file (filename);
+    ASSERT_EQ (file.size(), polygons.size());
+    for (std::size_t i = 0; i < polygons.size(); ++i) {
+        const std::span<const Point> points = file.points (i);
+        EXPECT_EQ (Points (points.begin(), points.end()), polygons[i]);
+    }
+    EXPECT_THROW (file.points (polygons.size()), std::out_of_range);
+
+    // CSV -> binary -> CSV
+    const std::string csv_filename = testing::TempDir() + "polygon_file.csv";
+    fileio::convert_binary_to_csv (filename, 3, csv_filename);
+    fileio::convert_csv_to_binary ({csv_filename, csv_filename}, filename);
+
+    const fileio::PolygonFile converted (filename);
+    ASSERT_EQ (converted.size(), 2);
+    EXPECT_TRUE (std::ranges::equal (converted.points (1), polygons[3]));
+
+    // Not a binary polygon file
+    EXPECT_THROW (fileio::PolygonFile{csv_filename}, std::runtime_error);
+}
+
+TEST (FileIoTest, TikzLevelOfDetail) {
+    // A unit square with two vertices very close to a corner, which make a
+    // tiny triangle
+    const Points points{
+        {0., 0.}, {1., 0.}, {1., 1. / 3.}, {1., 1.}, {1e-3, 1.}, {0., 1.}, {0., 1. - 1e-3}
+    };
+    const Triangles triangles{{0, 1, 3}, {0, 3, 5}, {4, 5, 6}};
+    const std::vector<bool> clipped (points.size(), false);
+
+    const auto count = [] (const std::string& text, const std::string& pattern) {
+        std::size_t n = 0;
+        for (auto pos = text.find (pattern); pos != std::string::npos;
+             pos      = text.find (pattern, pos + 1))
+            n++;
+        return n;
+    };
+
+    const std::string full = fileio::string_tikz_polygon (points, clipped, triangles, 2.);
+    EXPECT_EQ (count (full, "\\draw[ultra thin]"), 3);
+    EXPECT_EQ (count (full, " -- \n"), 7);
+    EXPECT_NE (full.find ("(1, 0.333333)"), std::string::npos);
+
+    // At the scale of 2, the features smaller than 0.01 are 0.005 in size.
+    const std::string lod = fileio::string_tikz_polygon (
+        points, clipped, triangles, 2., {.precision = 3, .resolution = 0.01}
+    );
+    EXPECT_EQ (count (lod, "\\draw[ultra thin]"), 2);
+    EXPECT_EQ (count (lod, " -- \n"), 5);
+    EXPECT_NE (lod.find ("(1, 0.333)"), std::string::npos);
+}
+
+TEST (FileIoTest, MeshFiles) {
+    // A square of two triangles
+    const Points    points{{0., 0.}, {1., 0.}, {1., 1.}, {0., 1.}};
+    const Triangles triangles{{0, 1, 2}, {0, 2, 3}};
+
+    EXPECT_EQ (fileio::mesh_index_size (65536), 2);
+    EXPECT_EQ (fileio::mesh_index_size (65537), 4);
+    EXPECT_EQ (fileio::mesh_index_size (std::size_t{1} << 33), 8);
+
+    const auto read_file = [] (const std::string& filename) {
+        std::ifstream file (filename, std::ios::binary);
+        return std::string{std::istreambuf_iterator<char> (file), {}};
+    };
+
+    // Raw binary: header, 4 vertices, and 2 triangles of 16-bit indices
+    const std::string binary_filename = testing::TempDir() + "mesh.bin";
+    fileio::write_mesh_binary (binary_filename, points, triangles);
+    const std::string binary = read_file (binary_filename);
+    ASSERT_EQ (binary.size(), 32 + 16 * 4 + 2 * 3 * 2);
+    EXPECT_EQ (binary.substr (0, 7), "TRIMESH");
+    EXPECT_EQ (binary[12], 2);
+    EXPECT_EQ (binary[32 + 16 * 4 + 2 * 5], 3);
+
+    // Binary PLY: header, 4 vertices with z, and 2 lists of 3 indices
+    const std::string ply_filename = testing::TempDir() + "mesh.ply";
+    fileio::write_mesh_ply (ply_filename, points, triangles);
+    const std::string ply    = read_file (ply_filename);
+    const std::size_t header = ply.find ("end_header\n") + 11;
+    EXPECT_NE (
+        ply.find ("element face 2\nproperty list uchar ushort vertex_indices\n"), std::string::npos
+    );
+    ASSERT_EQ (ply.size(), header + 24 * 4 + 2 * (1 + 3 * 2));
+    EXPECT_EQ (ply[header + 24 * 4 + 7], 3);
+
+    // OBJ: indices from 1
+    const std::string obj_filename = testing::TempDir() + "mesh.obj";
+    fileio::write_mesh_obj (obj_filename, points, triangles);
+    EXPECT_EQ (
+        read_file (obj_filename), "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\nf 1 3 4\n"
+    );
+}
+
 //// Polygon
 TEST (PolygonTest, WindingDirection) {
     {
@@ -142,3 +450,808 @@ TEST (PolygonTest, WindingDirection) {
         EXPECT_EQ (poly_cw.winding_direction(), "cw");
     }
 }
+
+TEST (PolygonTest, WindingMethod) {
+    const std::vector<Point> square_ccw{
+        Point{0.0, 0.0},
+        Point{1.0, 0.0},
+        Point{1.0, 1.0},
+        Point{0.0, 1.0},
+        Point{0.0, 0.0}
+    };
+
+    for (const auto method :
+         {Polygon::WindingMethod::signed_area, Polygon::WindingMethod::ray_casting}) {
+        Polygon poly{std::vector<Point>{square_ccw}, method};
+        EXPECT_EQ (poly.winding_direction(), "ccw");
+    }
+
+    // Collinear points do not enclose any area.
+    std::vector<Point> points{Point{0.0, 0.0}, Point{1.0, 1.0}, Point{2.0, 2.0}, Point{0.0, 0.0}};
+    Polygon            line{std::move (points)};
+    EXPECT_EQ (line.winding_direction(), "unknown");
+}
+
+TEST (PolygonTest, Triangulate) {
+    // Triangulation of a regular polygon should consist of (n - 2) triangles,
+    // and the sum of their areas should be that of the polygon.
+    constexpr int count_vertices = 24;
+    const double  inc            = 2. * std::numbers::pi / static_cast<double> (count_vertices);
+
+    std::vector<Point> points;
+    for (std::size_t i : std::views::iota (0, count_vertices + 1)) {
+        const double q = static_cast<double> (i) * inc;
+        points.push_back (Point{std::cos (q), std::sin (q)});
+    }
+    Polygon poly{std::move (points)};
+
+    const Triangulation result = poly.triangulation();
+    EXPECT_EQ (result.triangles.size(), count_vertices - 2);
+    EXPECT_NEAR (result.area, .5 * count_vertices * std::sin (inc), 1e-12);
+    EXPECT_NEAR (poly.area(), .5 * count_vertices * std::sin (inc), 1e-12);
+}
+
+TEST (PolygonTest, TriangulateConcave) {
+    // A star whose vertices alternate between two radii is concave at every
+    // inner vertex. Its area is the sum of the triangles fanned from the center.
+    constexpr int count_vertices = 64;
+    const double  inc            = 2. * std::numbers::pi / static_cast<double> (count_vertices);
+    const double  r_outer        = 1.0;
+    const double  r_inner        = 0.4;
+
+    std::vector<Point> points;
+    for (std::size_t i : std::views::iota (0, count_vertices + 1)) {
+        const double q = static_cast<double> (i) * inc;
+        const double r = (i % 2 == 0) ? r_outer : r_inner;
+        points.push_back (Point{r * std::cos (q), r * std::sin (q)});
+    }
+    Polygon poly{std::move (points)};
+
+    for (const EarOrder order : {EarOrder::fifo, EarOrder::quality}) {
+        const Triangles triangles = poly.triangulate ({.ear_order = order});
+        EXPECT_EQ (triangles.size(), count_vertices - 2);
+        EXPECT_NEAR (poly.area(), count_vertices * .5 * r_outer * r_inner * std::sin (inc), 1e-12);
+    }
+}
+
+TEST (PolygonTest, TriangulateMonotone) {
+    // A comb has several split and merge vertices, so the sweep has to insert
+    // diagonals before the monotone pieces can be triangulated.
+    Points comb{{0., 0.}, {7., 0.}, {7., 3.}, {6., 3.}, {6., 1.}, {5., 1.}, {5., 3.}, {4., 3.},
+                {4., 1.}, {3., 1.}, {3., 3.}, {2., 3.}, {2., 1.}, {1., 1.}, {1., 3.}, {0., 3.},
+                {0., 0.}};
+    Points reversed{comb.rbegin(), comb.rend()};
+
+    for (Points* points : {&comb, &reversed}) {
+        const std::size_t count_vertices = points->size() - 1;
+        Polygon           poly{std::move (*points)};
+        const Triangles   triangles = poly.triangulate ({.algorithm = Algorithm::monotone});
+        EXPECT_EQ (triangles.size(), count_vertices - 2);
+        EXPECT_NEAR (poly.area(), 15., 1e-12);
+    }
+}
+
+TEST (PolygonTest, TriangulateMonotoneNotSimple) {
+    // The vertex (44, 36) lies on the edge from (8, 36) to (60, 36), so the
+    // edge ending there is never in the status of the sweep. The result may be
+    // incomplete, as that of ear clipping, but the sweep must not fail.
+    const Polygon poly{
+        Points{{44., 36.}, {36., 32.}, {8., 36.}, {60., 36.}, {-36., 40.}, {40., 0.}, {44., 36.}}
+    };
+
+    ThreadPool pool{2};
+    for (ThreadPool* const p : {static_cast<ThreadPool*> (nullptr), &pool}) {
+        const Triangulation result =
+            poly.triangulation ({.algorithm = Algorithm::monotone, .pool = p});
+        EXPECT_LE (result.triangles.size(), poly.size() - 2);
+        EXPECT_TRUE (poly.covers (result));
+    }
+}
+
+TEST (PolygonTest, Metrics) {
+    // A square far from the origin, in both directions, with a collinear
+    // vertex on an edge
+    for (const bool ccw : {true, false}) {
+        Points points{{1e6, 2e6}, {1e6 + 1., 2e6}, {1e6 + 2., 2e6}, {1e6 + 2., 2e6 + 2.},
+                      {1e6, 2e6 + 2.}, {1e6, 2e6}};
+        if (!ccw) std::ranges::reverse (points);
+        const Polygon poly{std::move (points)};
+
+        const PolygonMetrics& metrics = poly.metrics();
+        EXPECT_EQ (metrics.signed_area, ccw ? 4. : -4.);
+        EXPECT_EQ (poly.area(), 4.);
+        EXPECT_EQ (metrics.perimeter, 8.);
+        EXPECT_EQ (metrics.centroid, (Point{1e6 + 1., 2e6 + 1.}));
+        EXPECT_EQ (metrics.box.lower, (Point{1e6, 2e6}));
+        EXPECT_EQ (metrics.box.upper, (Point{1e6 + 2., 2e6 + 2.}));
+        EXPECT_TRUE (metrics.convex);
+    }
+
+    // Not convex: a spike going back along itself, a pentagram, which turns
+    // one way but goes around twice, and a comb
+    const std::array<Point, 7> spike{
+        Point{0., 0.}, Point{2., 0.}, Point{2., 2.}, Point{2., 3.}, Point{2., 2.}, Point{0., 2.},
+        Point{0., 0.}
+    };
+    EXPECT_FALSE (geometry::polygon_metrics (spike).convex);
+
+    Points pentagram;
+    for (int i = 0; i <= 5; ++i) {
+        const double q = 4. * std::numbers::pi * static_cast<double> (i % 5) / 5.;
+        pentagram.push_back (Point{std::cos (q), std::sin (q)});
+    }
+    EXPECT_FALSE (geometry::polygon_metrics (pentagram).convex);
+
+    const std::array<PointI, 9> comb{
+        PointI{0, 0}, PointI{3, 0}, PointI{3, 2}, PointI{2, 2}, PointI{2, 1}, PointI{1, 1},
+        PointI{1, 2}, PointI{0, 2}, PointI{0, 0}
+    };
+    const PolygonMetrics comb_metrics = geometry::polygon_metrics (std::span<const PointI>{comb});
+    EXPECT_EQ (comb_metrics.signed_area, 5.);
+    EXPECT_EQ (comb_metrics.perimeter, 12.);
+    EXPECT_FALSE (comb_metrics.convex);
+
+    // A regular polygon, and random polygons, whose triangulation covers them
+    // unless a triangle is missing
+    constexpr std::size_t count_vertices = 1000;
+    const Polygon regular{[&] {
+        Points points = place_points_around_circle (1., count_vertices);
+        points.push_back (points.front());
+        return points;
+    }()};
+    const double inc = 2. * std::numbers::pi / static_cast<double> (count_vertices);
+    EXPECT_NEAR (regular.area(), .5 * count_vertices * std::sin (inc), 1e-12);
+    EXPECT_NEAR (regular.metrics().perimeter, 2. * count_vertices * std::sin (inc / 2.), 1e-12);
+    EXPECT_NEAR (regular.metrics().centroid.x, 0., 1e-12);
+    EXPECT_NEAR (regular.metrics().centroid.y, 0., 1e-12);
+    EXPECT_TRUE (regular.metrics().convex);
+
+    // The first calls from several threads compute the metrics only once.
+    {
+        Points points = place_points_around_circle (1., count_vertices);
+        points.push_back (points.front());
+        const Polygon poly{std::move (points)};
+
+        ThreadPool          pool{4};
+        std::vector<double> areas (64);
+        pool.for_each (areas.size(), [&] (const std::size_t i) { areas[i] = poly.area(); });
+        for (const double area : areas) EXPECT_EQ (area, regular.area());
+    }
+
+    for (std::uint64_t seed = 0; seed < 8; ++seed) {
+        Points points = random_polygon (count_vertices, {.seed = seed});
+        points.push_back (points.front());
+        const double area = geometry::signed_area (points);
+        const Polygon poly{std::move (points)};
+
+        EXPECT_NEAR (poly.metrics().signed_area, area, 1e-9);
+        EXPECT_FALSE (poly.metrics().convex);
+
+        Triangulation result = poly.triangulation();
+        EXPECT_TRUE (poly.covers (result));
+        result.area -= geometry::area (
+            poly.points()[result.triangles.back()[0]],
+            poly.points()[result.triangles.back()[1]],
+            poly.points()[result.triangles.back()[2]]
+        );
+        EXPECT_FALSE (poly.covers (result));
+    }
+}
+
+TEST (PolygonTest, View) {
+    // A view over an array owned by the caller triangulates the same as a
+    // polygon owning a copy of the points.
+    const std::array<Point, 7> points{
+        Point{0., 0.}, Point{4., 0.}, Point{4., 3.}, Point{2., 1.}, Point{0., 3.}, Point{1., 1.},
+        Point{0., 0.}
+    };
+    const PolygonView view{points};
+    EXPECT_EQ (view.size(), 6);
+    EXPECT_EQ (view.points().data(), points.data());
+    EXPECT_EQ (view.winding_direction(), "ccw");
+
+    Points        copy (points.begin(), points.end());
+    const Point*  data = copy.data();
+    const Polygon poly{std::move (copy)};
+    EXPECT_EQ (poly.points().data(), data);  // Moved, not copied
+
+    for (const Algorithm algorithm : {Algorithm::ear_clipping, Algorithm::monotone}) {
+        const Triangulation result   = view.triangulation ({.algorithm = algorithm});
+        const Triangulation expected = poly.triangulation ({.algorithm = algorithm});
+        EXPECT_EQ (result.triangles, expected.triangles);
+        EXPECT_EQ (result.triangles.size(), 4);
+        EXPECT_NEAR (result.area, 6.5, 1e-12);
+    }
+}
+
+TEST (PolygonTest, CoordinateTypes) {
+    // The same comb in float, double and fixed-point coordinates gives the same
+    // triangles.
+    const Points comb{{0., 0.}, {5., 0.}, {5., 3.}, {4., 3.}, {4., 1.}, {3., 1.}, {3., 3.},
+                      {2., 3.}, {2., 1.}, {1., 1.}, {1., 3.}, {0., 3.}, {0., 0.}};
+
+    std::vector<PointF> comb_f;
+    std::vector<PointI> comb_i;
+    for (const Point& p : comb) {
+        comb_f.push_back (PointF{static_cast<float> (p.x), static_cast<float> (p.y)});
+        comb_i.push_back (PointI{static_cast<std::int64_t> (p.x), static_cast<std::int64_t> (p.y)});
+    }
+
+    const PolygonView  view{comb};
+    const PolygonViewF view_f{comb_f};
+    const PolygonViewI view_i{comb_i, WindingMethod::ray_casting};
+    EXPECT_EQ (view_i.winding_direction(), "ccw");
+
+    for (const Algorithm algorithm : {Algorithm::ear_clipping, Algorithm::monotone}) {
+        const Triangulation expected = view.triangulation ({.algorithm = algorithm});
+        EXPECT_NEAR (expected.area, 11., 1e-12);
+
+        const Triangulation result_f = view_f.triangulation ({.algorithm = algorithm});
+        EXPECT_EQ (result_f.triangles, expected.triangles);
+        EXPECT_NEAR (result_f.area, expected.area, 1e-12);
+
+        const Triangulation result_i = view_i.triangulation ({.algorithm = algorithm});
+        EXPECT_EQ (result_i.triangles, expected.triangles);
+        EXPECT_NEAR (result_i.area, expected.area, 1e-12);
+    }
+
+    // Exact orientation of fixed-point coordinates, whose products do not fit
+    // in the 53 bits of double
+    constexpr std::int64_t n = geometry::fixed_point_limit - 1;
+    const PointI           o{0, 0};
+    EXPECT_EQ (geometry::orientation (o, PointI{n, n - 1}, PointI{n - 1, n - 2}), -1.);
+    EXPECT_EQ (geometry::orientation (o, PointI{n - 1, n - 2}, PointI{n, n - 1}), 1.);
+
+    const std::vector<PointI> out_of_range{o, {geometry::fixed_point_limit, 0}, {0, 1}, o};
+    EXPECT_THROW (PolygonViewI{out_of_range}, std::out_of_range);
+
+    TriangulationObserver observer;
+    EXPECT_THROW (view_f.triangulation ({.observer = &observer}), std::invalid_argument);
+}
+
+TEST (PolygonTest, Observer) {
+    struct CountingObserver : TriangulationObserver {
+        void
+        on_begin (std::span<const Point>) override {
+            count_begin++;
+        }
+
+        void
+        on_ear_clipped (std::span<const Point>, const VertexRing& ring, const Triangles& triangles)
+            override {
+            EXPECT_EQ (ring.size(), count_vertices - triangles.size() + 1);
+            count_clipped++;
+        }
+
+        void
+        on_end (std::span<const Point>, const VertexRing&, const Triangles&) override {
+            count_end++;
+        }
+
+        std::size_t count_vertices = 0;
+        std::size_t count_begin    = 0;
+        std::size_t count_clipped  = 0;
+        std::size_t count_end      = 0;
+    };
+
+    std::vector<Point> points{
+        Point{0.0, 0.0},
+        Point{2.0, 0.0},
+        Point{2.0, 2.0},
+        Point{1.0, 1.0},
+        Point{0.0, 2.0},
+        Point{0.0, 0.0}
+    };
+    Polygon poly{std::move (points)};
+
+    CountingObserver observer;
+    observer.count_vertices = 5;
+
+    const Triangles triangles = poly.triangulate ({.observer = &observer});
+    EXPECT_EQ (observer.count_begin, 1);
+    EXPECT_EQ (observer.count_clipped + 1, triangles.size());
+    EXPECT_EQ (observer.count_end, 1);
+}
+
+//// Random
+TEST (RandomTest, Seeded) {
+    {
+        random_float_gen<double> gen_a{-1., 2., 42};
+        random_float_gen<double> gen_b{-1., 2., 42};
+        random_float_gen<double> gen_c{-1., 2., 43};
+
+        bool differs = false;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const double x = gen_a();
+            EXPECT_EQ (x, gen_b());
+            EXPECT_GE (x, -1.);
+            EXPECT_LT (x, 2.);
+            differs |= x != gen_c();
+        }
+        EXPECT_TRUE (differs);
+    }
+
+    {
+        // The largest number, from the state whose next output is all ones,
+        // stays below the upper bound, though 1 + (1 - 2^-24) rounds to 2 in
+        // float, and 1 + (1 - 2^-53) in double.
+        constexpr std::array<std::uint64_t, 4> all_ones{0, 0x4fc71c71c71c71c7, 0, 0};
+
+        random_float_gen<float> gen_f{1.f, 2.f};
+        gen_f.gen.state = all_ones;
+        EXPECT_EQ (gen_f(), std::nextafter (2.f, 1.f));
+
+        random_float_gen<double> gen_d{1., 2.};
+        gen_d.gen.state = all_ones;
+        EXPECT_EQ (gen_d(), std::nextafter (2., 1.));
+    }
+
+    {
+        // Every value in the range is generated.
+        random_int_gen<int>         gen{-2, 2, 7};
+        std::array<std::size_t, 5> counts{};
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const int x = gen();
+            ASSERT_GE (x, -2);
+            ASSERT_LE (x, 2);
+            counts[x + 2]++;
+        }
+        for (const std::size_t count : counts) EXPECT_GT (count, 100);
+    }
+
+    {
+        // The stream split off continues the sequence, and the rest jumps ahead.
+        xoshiro256       engine{1};
+        const xoshiro256 copy   = engine;
+        xoshiro256       stream = engine.split();
+        xoshiro256       expected{copy};
+        for (std::size_t i = 0; i < 100; ++i) {
+            const auto x = stream();
+            EXPECT_EQ (x, expected());
+            EXPECT_NE (x, engine());
+        }
+    }
+}
+
+// The numbers of the reference implementation of SplitMix64 and xoshiro256**
+// (prng.di.unimi.it), which every platform should reproduce
+TEST (RandomTest, KnownAnswer) {
+    xoshiro256 engine{12345};
+    EXPECT_EQ (
+        engine.state,
+        (std::array<std::uint64_t, 4>{
+            0x22118258a9d111a0, 0x346edce5f713f8ed, 0x1e9a57bc80e6721d, 0x2d160e7e5c3f42ca
+        })
+    );
+
+    EXPECT_EQ (engine(), 0xbe6a36374160d49b);
+    EXPECT_EQ (engine(), 0x214aaa0637a688c6);
+    EXPECT_EQ (engine(), 0xf69d16de9954d388);
+    EXPECT_EQ (engine(), 0x0c60048c4e96e033);
+
+    engine.jump();
+    EXPECT_EQ (
+        engine.state,
+        (std::array<std::uint64_t, 4>{
+            0xdf3be8881ce8b544, 0xdf6ee195f765120f, 0x1ebf10b540dc95e8, 0x22a85c6b43bd7b5e
+        })
+    );
+    EXPECT_EQ (engine(), 0x3ed3ae3e6216531e);
+}
+
+//// Random Polygon
+TEST (RandomPolygonTest, Simple) {
+    constexpr std::size_t count_points = 500;
+
+    const Points points = random_polygon (count_points);
+    ASSERT_EQ (points.size(), count_points);
+
+    // No edge touches another, except the edges next to it at the ends.
+    const auto next = [] (const std::size_t k) { return (k + 1) % count_points; };
+    for (std::size_t i = 0; i < count_points; ++i) {
+        for (std::size_t j = i + 1; j < count_points; ++j) {
+            const bool adjacent = j == i + 1 || next (j) == i;
+            EXPECT_FALSE (geometry::does_intersect (
+                points[i],
+                points[next (i)],
+                points[j],
+                points[next (j)],
+                geometry::LineType::segment,
+                adjacent
+            )) << "edges " << i << " and " << j;
+        }
+    }
+
+    Points closed = points;
+    closed.push_back (points.front());
+    Polygon poly{std::move (closed)};
+    EXPECT_EQ (poly.winding_direction(), "ccw");
+    EXPECT_EQ (poly.triangulate().size(), count_points - 2);
+
+    // The same seed gives the same polygon.
+    EXPECT_EQ (random_polygon (count_points), points);
+    EXPECT_NE (random_polygon (count_points, {.seed = 1}), points);
+}
+
+//// Triangulator
+TEST (TriangulatorTest, ReusedWorkspace) {
+    // Polygons of various sizes, triangulated one after another by the same
+    // triangulator, give the same results as Polygon::triangulation().
+    std::vector<Polygon> polygons;
+    for (const std::size_t count_points : {50, 8, 200, 3, 120}) {
+        Points points = random_polygon (count_points, {.seed = count_points});
+        points.push_back (points.front());
+        polygons.emplace_back (std::move (points));
+    }
+
+    Triangulator triangulator;
+    for (const Algorithm algorithm : {Algorithm::ear_clipping, Algorithm::monotone}) {
+        for (const EarOrder order : {EarOrder::fifo, EarOrder::quality}) {
+            const TriangulationOptions options{.algorithm = algorithm, .ear_order = order};
+            for (const Polygon& polygon : polygons) {
+                const Triangulation  expected = polygon.triangulation (options);
+                const Triangulation& result   = triangulator.triangulate (polygon, options);
+                EXPECT_EQ (result.triangles, expected.triangles);
+                EXPECT_EQ (result.area, expected.area);
+            }
+        }
+    }
+
+    // Once the arena has grown to the largest polygon, it is not reallocated.
+    const std::size_t arena_size = triangulator.arena_size();
+    EXPECT_GT (arena_size, 0);
+    for (const Polygon& polygon : polygons) triangulator.triangulate (polygon);
+    EXPECT_EQ (triangulator.arena_size(), arena_size);
+}
+
+//// Incremental Triangulation
+namespace {
+
+// Check that the triangles of the polygon from the vertex `first` cover it
+// with counter-clockwise triangles.
+void
+expect_triangulated (const IncrementalTriangulation& mesh, const std::size_t first) {
+    Points      ring;
+    std::size_t v = first;
+    do {
+        ring.push_back (mesh.point (v));
+        v = mesh.next (v);
+    } while (v != first);
+    ring.push_back (ring.front());
+    ASSERT_EQ (ring.size(), mesh.size() + 1);
+
+    const Triangles triangles = mesh.triangles();
+    EXPECT_EQ (triangles.size(), mesh.size() - 2);
+
+    double sum = 0.;
+    for (const auto& [a, b, c] : triangles) {
+        EXPECT_GT (geometry::orientation (mesh.point (a), mesh.point (b), mesh.point (c)), 0.);
+        sum += geometry::area (mesh.point (a), mesh.point (b), mesh.point (c));
+    }
+
+    const double area = geometry::signed_area (ring);
+    EXPECT_NEAR (sum, area, 1e-12);
+    EXPECT_NEAR (mesh.area(), area, 1e-12);
+}
+
+}  // namespace
+
+TEST (IncrementalTest, LocalEdits) {
+    // Edits of a regular polygon which keep it star-shaped around the origin
+    constexpr std::size_t count_points = 300;
+
+    Points points = place_points_around_circle (1., count_points);
+    points.push_back (points.front());
+    IncrementalTriangulation mesh{points};
+    expect_triangulated (mesh, 0);
+
+    random_float_gen<double> random{0., 1., 11};
+    const auto               scaled = [&random] (const Point& p) {
+        const double s = 1. + .02 * (random() - .5);
+        return Point{s * p.x, s * p.y};
+    };
+
+    std::size_t v = 1;
+    for (int i = 0; i < 600; ++i) {
+        switch (i % 3) {
+        case 0: mesh.move_vertex (v, scaled (mesh.point (v))); break;
+        case 1:
+            v = mesh.insert_vertex (
+                v,
+                scaled (geometry::midpoint (mesh.point (v), mesh.point (mesh.next (v))))
+            );
+            break;
+        case 2: mesh.remove_vertex (std::exchange (v, mesh.next (v))); break;
+        }
+        expect_triangulated (mesh, 0);
+
+        // Vertex 0 is never removed.
+        for (int j = 0; j < 7 || v == 0; ++j) v = mesh.next (v);
+    }
+
+    // Every edit stayed around the edited vertex.
+    EXPECT_EQ (mesh.size(), count_points);
+    EXPECT_EQ (mesh.count_rebuilds(), 0);
+}
+
+TEST (IncrementalTest, Rebuild) {
+    Points points{{0., 0.}, {1., 0.}, {1., 1.}, {0., 1.}, {0., 0.}};
+    IncrementalTriangulation mesh{points};
+
+    // The edge from (1, 0) crosses the edge from (0, 1), so no cavity can be
+    // triangulated by itself.
+    mesh.move_vertex (2, Point{-1., .5});
+    EXPECT_EQ (mesh.count_rebuilds(), 1);
+
+    mesh.move_vertex (2, Point{1., 1.});
+    expect_triangulated (mesh, 0);
+    EXPECT_NEAR (mesh.area(), 1., 1e-12);
+
+    const std::size_t v = mesh.insert_vertex (3, Point{-.5, .5});
+    expect_triangulated (mesh, 0);
+    EXPECT_NEAR (mesh.area(), 1.25, 1e-12);
+
+    mesh.remove_vertex (v);
+    mesh.remove_vertex (3);
+    expect_triangulated (mesh, 0);
+
+    // A triangle cannot lose a vertex, and the vertex 3 is gone.
+    EXPECT_THROW (mesh.remove_vertex (2), std::invalid_argument);
+    EXPECT_THROW (mesh.move_vertex (3, Point{}), std::out_of_range);
+}
+
+//// Triangulation Cache
+
+// Random polygon whose coordinates are multiples of 1/1024, so that it is
+// translated exactly by integers
+Points
+polygon_on_grid (const std::size_t count_points, const std::uint64_t seed) {
+    Points points = random_polygon (count_points, {.seed = seed});
+    for (Point& p : points) {
+        p = {std::round (p.x * 1024.) / 1024., std::round (p.y * 1024.) / 1024.};
+    }
+    points.push_back (points.front());
+    return points;
+}
+
+TEST (CacheTest, Lookup) {
+    const Points        points   = polygon_on_grid (200, 1);
+    const Triangulation expected = PolygonView{points}.triangulation();
+
+    TriangulationCache         cache{1 << 20};
+    const TriangulationOptions options{.cache = &cache};
+    EXPECT_EQ (PolygonView{points}.triangulation (options).triangles, expected.triangles);
+    EXPECT_EQ (PolygonView{points}.triangulation (options).triangles, expected.triangles);
+    EXPECT_EQ (cache.size(), 1);
+    EXPECT_EQ (cache.count_hits(), 1);
+    EXPECT_EQ (cache.count_misses(), 1);
+
+    // A translated copy is found, but not a scaled one, nor the same polygon
+    // triangulated with other options.
+    Points translated = points;
+    for (Point& p : translated) p += Point{100., -7.};
+    const Triangulation found = PolygonView{translated}.triangulation (options);
+    EXPECT_EQ (found.triangles, expected.triangles);
+    EXPECT_EQ (found.area, expected.area);
+    EXPECT_EQ (cache.count_hits(), 2);
+
+    Points scaled = points;
+    for (Point& p : scaled) p = {2. * p.x, 2. * p.y};
+    PolygonView{scaled}.triangulation (options);
+    PolygonView{points}.triangulation ({.algorithm = Algorithm::monotone, .cache = &cache});
+    EXPECT_EQ (cache.count_hits(), 2);
+    EXPECT_EQ (cache.size(), 3);
+
+    // Written to a file and read back, in the order of use
+    const std::string filename = testing::TempDir() + "triangulation_cache.bin";
+    cache.save (filename);
+
+    TriangulationCache loaded{cache.bytes()};
+    loaded.load (filename);
+    EXPECT_EQ (loaded.size(), 3);
+    EXPECT_EQ (loaded.bytes(), cache.bytes());
+    EXPECT_EQ (
+        PolygonView{translated}.triangulation ({.cache = &loaded}).triangles, expected.triangles
+    );
+    EXPECT_EQ (loaded.count_hits(), 1);
+
+    // The least recently used polygon is dropped beyond the capacity.
+    const Points other = polygon_on_grid (100, 2);
+    PolygonView{other}.triangulation ({.cache = &loaded});
+    EXPECT_EQ (loaded.size(), 3);
+    EXPECT_LE (loaded.bytes(), loaded.capacity());
+    PolygonView{scaled}.triangulation ({.cache = &loaded});
+    EXPECT_EQ (loaded.count_hits(), 1);
+
+    std::ofstream{filename} << "0, 0\n";
+    EXPECT_THROW (loaded.load (filename), std::runtime_error);
+}
+
+TEST (CacheTest, Batch) {
+    // A few outlines repeated at many places
+    std::vector<Points> outlines;
+    for (std::uint64_t seed = 0; seed < 4; ++seed) outlines.push_back (polygon_on_grid (150, seed));
+
+    std::vector<Points> placed;
+    for (int i = 0; i < 64; ++i) {
+        placed.push_back (outlines[i % outlines.size()]);
+        for (Point& p : placed.back()) p += Point{static_cast<double> (i), 0.};
+    }
+    std::vector<PolygonView> views (placed.begin(), placed.end());
+
+    ThreadPool                       pool{4};
+    TriangulationCache               cache{1 << 20};
+    const std::vector<Triangulation> expected = triangulate_batch (views, pool);
+    const std::vector<Triangulation> results  = triangulate_batch (views, pool, {.cache = &cache});
+
+    ASSERT_EQ (results.size(), expected.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ (results[i].triangles, expected[i].triangles);
+    }
+    EXPECT_EQ (cache.size(), outlines.size());
+    EXPECT_EQ (cache.count_hits() + cache.count_misses(), placed.size());
+    EXPECT_GE (cache.count_hits(), placed.size() - pool.size() * outlines.size());
+}
+
+//// Batch
+TEST (BatchTest, TriangulateBatch) {
+    // Regular polygons of various sizes, whose areas are known
+    std::vector<Polygon> polygons;
+    for (int i = 0; i < 40; ++i) {
+        const int    count_vertices = 3 + (i * 37) % 200;
+        const double inc            = 2. * std::numbers::pi / static_cast<double> (count_vertices);
+
+        std::vector<Point> points;
+        for (int j = 0; j <= count_vertices; ++j) {
+            const double q = static_cast<double> (j % count_vertices) * inc;
+            points.push_back (Point{std::cos (q), std::sin (q)});
+        }
+        polygons.emplace_back (std::move (points));
+    }
+
+    ThreadPool pool{4};
+    for (const Algorithm algorithm : {Algorithm::ear_clipping, Algorithm::monotone}) {
+        const std::vector<Triangulation> results =
+            triangulate_batch (polygons, pool, {.algorithm = algorithm});
+
+        ASSERT_EQ (results.size(), polygons.size());
+        for (std::size_t i = 0; i < polygons.size(); ++i) {
+            const double count_vertices = static_cast<double> (polygons[i].size());
+            EXPECT_EQ (results[i].triangles.size(), polygons[i].size() - 2);
+            EXPECT_NEAR (
+                results[i].area,
+                .5 * count_vertices * std::sin (2. * std::numbers::pi / count_vertices),
+                1e-12
+            );
+        }
+    }
+
+    TriangulationObserver observer;
+    EXPECT_THROW (triangulate_batch (polygons, pool, {.observer = &observer}), std::invalid_argument);
+}
+
+TEST (BatchTest, TriangulateParallel) {
+    // A random star has many split and merge vertices, hence many pieces.
+    random_float_gen<double> rng{0.2, 1.2};
+    constexpr int            count_vertices = 2000;
+    const double             inc = 2. * std::numbers::pi / static_cast<double> (count_vertices);
+
+    std::vector<Point> points;
+    for (int i = 0; i < count_vertices; ++i) {
+        const double q = static_cast<double> (i) * inc;
+        const double r = rng();
+        points.push_back (Point{r * std::cos (q), r * std::sin (q)});
+    }
+    points.push_back (points.front());
+    Polygon poly{std::move (points)};
+
+    ThreadPool      pool{4};
+    const Triangles serial = poly.triangulate ({.algorithm = Algorithm::monotone});
+    const Triangles parallel =
+        poly.triangulate ({.algorithm = Algorithm::monotone, .pool = &pool});
+
+    EXPECT_EQ (serial.size(), count_vertices - 2);
+    EXPECT_EQ (parallel, serial);
+}
+
+TEST (BatchTest, ThreadPoolRethrows) {
+    ThreadPool       pool{3};
+    std::atomic<int> count{0};
+
+    EXPECT_THROW (
+        pool.for_each (
+            100,
+            [&] (const std::size_t i) {
+                count++;
+                if (i == 42) throw std::runtime_error ("task failed");
+            }
+        ),
+        std::runtime_error
+    );
+    EXPECT_EQ (count, 100);
+}
+
+//// Stream
+TEST (StreamTest, TriangulateStream) {
+    // Three polygons separated by empty lines: a unit square, the comb of
+    // TriangulateMonotone, and a triangle without a newline at the end
+    const std::string text =
+        "\n"
+        "0, 0\n1, 0\n1, 1\n0, 1\n0, 0\n"
+        " \r\n"
+        "\n"
+        "0,0\r\n6,0\r\n6,4\r\n5,4\r\n5,1\r\n4,1\r\n4,4\r\n3,4\r\n3,1\r\n2,1\r\n2,4\r\n"
+        "1,4\r\n1,1\r\n0,1\r\n0,0\r\n"
+        "\n"
+        "0, 0\n2, 0\n0, 2\n0, 0";
+
+    // Blocks much shorter than a polygon split the lines at every position.
+    std::istringstream       in (text);
+    fileio::CsvPolygonReader reader (in, 5);
+
+    std::vector<Triangulation> results;
+    const std::size_t          count = triangulate_stream (
+        [&] { return reader.next(); },
+        [&] (const Triangulation& result) { results.push_back (result); },
+        {.queue_capacity = 1, .triangulation = {}}
+    );
+
+    ASSERT_EQ (count, 3);
+    ASSERT_EQ (results.size(), 3);
+    EXPECT_EQ (results[0].triangles.size(), 2);
+    EXPECT_NEAR (results[0].area, 1., 1e-12);
+    EXPECT_EQ (results[1].triangles.size(), 12);
+    EXPECT_NEAR (results[1].area, 15., 1e-12);
+    EXPECT_EQ (results[2].triangles.size(), 1);
+    EXPECT_NEAR (results[2].area, 2., 1e-12);
+}
+
+TEST (StreamTest, TriangulateStreamRethrows) {
+    // The second polygon has a coordinate which is not a number.
+    std::istringstream       in ("0, 0\n1, 0\n0, 1\n0, 0\n\n0, 0\n1, x\n");
+    fileio::CsvPolygonReader reader (in);
+
+    std::size_t count = 0;
+    EXPECT_THROW (
+        triangulate_stream (
+            [&] { return reader.next(); }, [&] (const Triangulation&) { count++; }
+        ),
+        std::invalid_argument
+    );
+    EXPECT_LE (count, 1);
+
+    // A failure in writing stops the other stages.
+    const auto read = [] { return std::optional<Points>{Points{{0, 0}, {1, 0}, {0, 1}, {0, 0}}}; };
+    EXPECT_THROW (
+        triangulate_stream (read, [] (const Triangulation&) { throw std::runtime_error ("full"); }),
+        std::runtime_error
+    );
+}
+
+//// Trace
+TEST (TraceTest, EarClippedEvents) {
+    std::vector<Point> points{
+        Point{0.0, 0.0},
+        Point{1.0, 0.0},
+        Point{1.0, 1.0},
+        Point{0.0, 1.0},
+        Point{0.0, 0.0}
+    };
+    Polygon square{std::move (points)};
+
+    std::size_t count_clipped = 0;
+    trace::set_sink (
+        [&count_clipped] (const trace::Event& event) {
+            if (event.kind == trace::EventKind::ear_clipped) count_clipped++;
+        },
+        trace::mask_of (trace::EventKind::ear_clipped)
+    );
+    const Triangles triangles = square.triangulate();
+    trace::reset_sink();
+
+    if constexpr (static_cast<int> (trace::Level::debug) <= TRIANGULATE_TRACE_LEVEL) {
+        EXPECT_EQ (count_clipped, triangles.size());
+    } else {
+        EXPECT_EQ (count_clipped, 0);
+    }
+}